@@ -1,5 +1,8 @@
 #include "hazkey_candidate.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "commands.pb.h"
@@ -25,16 +28,55 @@ void HazkeyCandidateWord::select(InputContext* ic) const {
 
 /// CandidateList
 
-HazkeyCandidateList::HazkeyCandidateList(
-    const google::protobuf::RepeatedPtrField<
-        ::hazkey::commands::CandidatesResult_Candidate>
-        candidates)
+namespace {
+
+std::unique_ptr<HazkeyCandidateWord> takeCandidateWord(
+    int index, hazkey::commands::CandidatesResult_Candidate* candidate) {
+    return std::make_unique<HazkeyCandidateWord>(
+        index, std::move(*candidate->mutable_text()),
+        std::move(*candidate->mutable_sub_hiragana()));
+}
+
+}  // namespace
+
+HazkeyCandidateList::HazkeyCandidateList(CandidateField* candidates)
     : CommonCandidateList() {
-    // CandidateWord needs to know their own index
-    int i = 0;
-    for (const auto& candidate : candidates) {
-        append(std::make_unique<HazkeyCandidateWord>(i, candidate));
-        i++;
+    update(candidates);
+}
+
+void HazkeyCandidateList::update(CandidateField* candidates) {
+    // The lists of consecutive keys mostly share their head, so a word is
+    // only rebuilt where the candidate at its position changed.
+    // CandidateWord needs to know their own index, which is its position.
+    int newSize = candidates->size();
+    int kept = std::min(totalSize(), newSize);
+    for (int i = 0; i < kept; i++) {
+        auto& word =
+            static_cast<const HazkeyCandidateWord&>(candidateFromAll(i));
+        if (!word.sameAs(candidates->Get(i))) {
+            replace(i, takeCandidateWord(i, candidates->Mutable(i)));
+        }
+    }
+    while (totalSize() > newSize) {
+        remove(totalSize() - 1);
+    }
+    for (int i = kept; i < newSize; i++) {
+        append(takeCandidateWord(i, candidates->Mutable(i)));
+    }
+    setPage(0);
+    setGlobalCursorIndex(-1);
+    setPaging(0, 0);
+}
+
+void HazkeyCandidateList::setPaging(uint64_t version, int totalCount) {
+    pagingVersion_ = version;
+    pagingTotal_ = totalCount;
+}
+
+void HazkeyCandidateList::appendCandidates(CandidateField* candidates) {
+    int offset = totalSize();
+    for (int i = 0; i < candidates->size(); i++) {
+        append(takeCandidateWord(offset + i, candidates->Mutable(i)));
     }
 }
 
@@ -5,6 +5,8 @@
 #include <fcitx/inputcontext.h>
 #include <fcitx/text.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -22,13 +24,17 @@ const KeyList defaultSelectionKeys = {
 
 class HazkeyCandidateWord : public CandidateWord {
    public:
-    HazkeyCandidateWord(const int index,
-                        const hazkey::commands::CandidatesResult_Candidate data)
-        : CandidateWord(Text(data.text())),
+    HazkeyCandidateWord(const int index, std::string candidate,
+                        std::string hiragana)
+        : CandidateWord(Text(candidate)),
           index_(index),
-          candidate_(std::move(data.text())),
-          hiragana_(std::move(data.sub_hiragana())) {
-        setText(Text(data.text()));
+          candidate_(std::move(candidate)),
+          hiragana_(std::move(hiragana)) {}
+
+    // whether this word shows the same candidate as data
+    bool sameAs(
+        const hazkey::commands::CandidatesResult_Candidate& data) const {
+        return candidate_ == data.text() && hiragana_ == data.sub_hiragana();
     }
 
     // called when the candidate is selected (by pointing device?)
@@ -49,11 +55,27 @@ class HazkeyCandidateWord : public CandidateWord {
     // const std::vector<int> part_lens_;
 };
 
+using CandidateField = google::protobuf::RepeatedPtrField<
+    hazkey::commands::CandidatesResult_Candidate>;
+
 class HazkeyCandidateList : public CommonCandidateList {
    public:
-    HazkeyCandidateList(google::protobuf::RepeatedPtrField<
-                        hazkey::commands::CandidatesResult_Candidate>
-                            candidates);
+    // the strings are moved out of candidates
+    explicit HazkeyCandidateList(CandidateField* candidates);
+
+    // Replaces the candidates with new ones, keeping the words that did not
+    // change. The strings are moved out of candidates. The cursor is reset.
+    void update(CandidateField* candidates);
+
+    // the server holds totalCount candidates for the result with version,
+    // of which only the first ones are loaded
+    void setPaging(uint64_t version, int totalCount);
+    uint64_t pagingVersion() const { return pagingVersion_; }
+    // loaded or not
+    int fullSize() const { return std::max(totalSize(), pagingTotal_); }
+    bool fullyLoaded() const { return totalSize() >= pagingTotal_; }
+    // appends the next loaded candidates, moving their strings
+    void appendCandidates(CandidateField* candidates);
 
     // return the direction of the candidate list
     // currently always vertical
@@ -74,6 +96,10 @@ class HazkeyCandidateList : public CommonCandidateList {
 
     // whether the candidate list is focused
     bool focused() const;
+
+   private:
+    uint64_t pagingVersion_ = 0;
+    int pagingTotal_ = 0;
 };
 
 }  // namespace fcitx
@@ -5,6 +5,7 @@
 #include "hazkey_server_connector.h"
 #include "hazkey_state.h"
 #include "hazkey_constants.h"
+#include "hazkey_trace.h"
 
 namespace fcitx {
 
@@ -12,7 +13,7 @@ HazkeyEngine::HazkeyEngine(Instance *instance)
     : instance_(instance), factory_([this](InputContext &ic) {
           return new HazkeyState(this, &ic);
       }) {
-    server_ = HazkeyServerConnector();
+    server_.startWorker(&instance->eventLoop());
 
     instance->inputContextManager().registerProperty("hazkeyState", &factory_);
     reloadConfig();
@@ -34,6 +35,8 @@ void HazkeyEngine::activate([[maybe_unused]] const InputMethodEntry &entry,
     FCITX_DEBUG() << "HazkeyEngine activate";
     auto inputContext = event.inputContext();
     auto state = inputContext->propertyFor(&factory_);
+    // the profile may have changed in hazkey-settings
+    server_.refreshInputModeInfo();
     state->reset();
     inputContext->updatePreedit();
     inputContext->updateUserInterface(UserInterfaceComponent::InputPanel);
@@ -72,6 +75,9 @@ void HazkeyEngine::reloadConfig() {
 
 void HazkeyEngine::save() {
     server_.saveLearningData();
+    if (HazkeyTracer::instance().enabled()) {
+        HazkeyTracer::instance().flush(server_.flushServerTrace());
+    }
 }
 
 FCITX_ADDON_FACTORY(HazkeyEngineFactory);
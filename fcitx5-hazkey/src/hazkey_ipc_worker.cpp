@@ -0,0 +1,95 @@
+#include "hazkey_ipc_worker.h"
+
+#include <fcitx-utils/log.h>
+
+#include <future>
+#include <memory>
+#include <utility>
+
+#include "hazkey_trace.h"
+
+HazkeyIpcWorker::HazkeyIpcWorker(Transport transport,
+                                 fcitx::EventLoop* eventLoop)
+    : transport_(std::move(transport)) {
+    dispatcher_.attach(eventLoop);
+    thread_ = std::thread([this]() { run(); });
+}
+
+HazkeyIpcWorker::~HazkeyIpcWorker() {
+    stopping_.store(true, std::memory_order_release);
+    wakeups_.fetch_add(1, std::memory_order_release);
+    wakeups_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    dispatcher_.detach();
+}
+
+std::optional<hazkey::ResponseEnvelope> HazkeyIpcWorker::transact(
+    hazkey::RequestEnvelope request, uint64_t traceId) {
+    using Result = std::optional<hazkey::ResponseEnvelope>;
+    auto promise = std::make_shared<std::promise<Result>>();
+    auto future = promise->get_future();
+    enqueue(Job{std::move(request), traceId,
+                [promise](std::optional<hazkey::ResponseEnvelope> response) {
+                    promise->set_value(std::move(response));
+                }});
+    return future.get();
+}
+
+void HazkeyIpcWorker::post(hazkey::RequestEnvelope request, uint64_t traceId,
+                           Completion completion) {
+    enqueue(Job{std::move(request), traceId, std::move(completion)});
+}
+
+void HazkeyIpcWorker::transactAsync(hazkey::RequestEnvelope request,
+                                    uint64_t traceId, Completion completion) {
+    enqueue(Job{std::move(request), traceId,
+                [this, completion = std::move(completion)](
+                    std::optional<hazkey::ResponseEnvelope> response) {
+                    dispatcher_.schedule(
+                        [completion, response = std::move(response)]() {
+                            completion(response);
+                        });
+                }});
+}
+
+void HazkeyIpcWorker::enqueue(Job job) {
+    while (true) {
+        uint32_t drained = drained_.load(std::memory_order_acquire);
+        if (queue_.push(std::move(job))) {
+            break;
+        }
+        // Only when the server stopped answering for 256 requests: sleep
+        // until the worker takes one instead of spinning on the main thread.
+        drained_.wait(drained, std::memory_order_acquire);
+    }
+    wakeups_.fetch_add(1, std::memory_order_release);
+    wakeups_.notify_one();
+}
+
+void HazkeyIpcWorker::run() {
+    auto& tracer = HazkeyTracer::instance();
+    while (true) {
+        uint32_t seen = wakeups_.load(std::memory_order_acquire);
+        while (auto job = queue_.pop()) {
+            drained_.fetch_add(1, std::memory_order_release);
+            drained_.notify_one();
+            uint64_t startUs = tracer.enabled() ? HazkeyTracer::nowUs() : 0;
+            auto response = transport_(job->request, job->traceId);
+            if (tracer.enabled()) {
+                tracer.record("HazkeyIpcWorker::job", job->traceId, startUs,
+                              HazkeyTracer::nowUs() - startUs);
+            }
+            if (job->completion) {
+                job->completion(std::move(response));
+            }
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+        // returns as soon as a push happened after the load above
+        wakeups_.wait(seen, std::memory_order_acquire);
+    }
+    FCITX_DEBUG() << "IPC worker stopped";
+}
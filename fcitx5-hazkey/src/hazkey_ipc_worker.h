@@ -0,0 +1,73 @@
+#ifndef HAZKEY_IPC_WORKER_H
+#define HAZKEY_IPC_WORKER_H
+
+#include <fcitx-utils/eventdispatcher.h>
+#include <fcitx-utils/eventloopinterface.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <thread>
+
+#include "base.pb.h"
+#include "hazkey_spsc_queue.h"
+
+// Thread that owns the hazkey-server connection. The fcitx main thread
+// queues requests without taking a lock; the server answers them in order.
+//
+// The decoupling is partial: post() and transactAsync() return at once, but
+// transact() still blocks the main thread for the round trip, behind any
+// request queued before it. Keys that need the server's state (Space,
+// Return, BackSpace, ...) therefore still wait for the server.
+class HazkeyIpcWorker {
+   public:
+    // sends one request and reads its response, on the worker thread
+    using Transport = std::function<std::optional<hazkey::ResponseEnvelope>(
+        const hazkey::RequestEnvelope& request, uint64_t traceId)>;
+    using Completion =
+        std::function<void(std::optional<hazkey::ResponseEnvelope> response)>;
+
+    HazkeyIpcWorker(Transport transport, fcitx::EventLoop* eventLoop);
+    // sends what is still queued, then joins the thread
+    ~HazkeyIpcWorker();
+
+    HazkeyIpcWorker(const HazkeyIpcWorker&) = delete;
+    HazkeyIpcWorker& operator=(const HazkeyIpcWorker&) = delete;
+
+    // Blocks until the response arrives, after everything queued before.
+    std::optional<hazkey::ResponseEnvelope> transact(
+        hazkey::RequestEnvelope request, uint64_t traceId);
+
+    // Returns immediately; completion runs on the worker thread.
+    void post(hazkey::RequestEnvelope request, uint64_t traceId,
+              Completion completion);
+
+    // Returns immediately; completion runs on the main thread.
+    void transactAsync(hazkey::RequestEnvelope request, uint64_t traceId,
+                       Completion completion);
+
+   private:
+    struct Job {
+        hazkey::RequestEnvelope request;
+        uint64_t traceId = 0;
+        Completion completion;
+    };
+
+    static constexpr size_t kQueueCapacity = 256;
+
+    void enqueue(Job job);
+    void run();
+
+    Transport transport_;
+    fcitx::EventDispatcher dispatcher_;
+    HazkeySpscQueue<Job, kQueueCapacity> queue_;
+    // bumped on every push so the worker can sleep on it
+    std::atomic<uint32_t> wakeups_{0};
+    // bumped on every pop so a producer facing a full queue can sleep on it
+    std::atomic<uint32_t> drained_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+#endif  // HAZKEY_IPC_WORKER_H
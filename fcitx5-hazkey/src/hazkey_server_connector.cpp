@@ -4,6 +4,7 @@
 #include <dirent.h>
 #include <fcitx-utils/log.h>
 #include <fcitx-utils/textformatflags.h>
+#include <fcitx-utils/utf8.h>
 #include <fcitx/text.h>
 #include <fcntl.h>
 #include <signal.h>
@@ -17,15 +18,13 @@
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
-#include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 
 #include "base.pb.h"
 #include "commands.pb.h"
-
-static std::mutex transact_mutex;
+#include "hazkey_trace.h"
 
 std::string HazkeyServerConnector::getSocketPath() {
     const char* xdg_runtime_dir = std::getenv("XDG_RUNTIME_DIR");
@@ -97,7 +96,16 @@ bool readAll(int fd, void* data, size_t len) {
     return true;
 }
 
+HazkeyServerConnector::HazkeyServerConnector(int connectedSocket)
+    : sock_(connectedSocket), canReconnect_(false) {
+    fcntl(sock_, F_SETFL, fcntl(sock_, F_GETFL, 0) | O_NONBLOCK);
+    connectionGeneration_.fetch_add(1, std::memory_order_release);
+}
+
 void HazkeyServerConnector::connectServer() {
+    if (!canReconnect_) {
+        return;
+    }
     std::string socket_path = getSocketPath();
 
     // try restarting server only 1 time
@@ -136,6 +144,7 @@ void HazkeyServerConnector::connectServer() {
         int ret = connect(sock_, (sockaddr*)&addr, sizeof(addr));
         if (ret == 0) {
             // Connected
+            connectionGeneration_.fetch_add(1, std::memory_order_release);
             return;
         }
         if (errno == EINPROGRESS) {
@@ -150,6 +159,8 @@ void HazkeyServerConnector::connectServer() {
                 getsockopt(sock_, SOL_SOCKET, SO_ERROR, &so_error, &len);
                 if (so_error == 0) {
                     // Connected
+                    connectionGeneration_.fetch_add(
+                        1, std::memory_order_release);
                     return;
                 }
             }
@@ -170,10 +181,56 @@ void HazkeyServerConnector::connectServer() {
                  << " attempts";
 }
 
+void HazkeyServerConnector::startWorker(fcitx::EventLoop* eventLoop) {
+    worker_ = std::make_unique<HazkeyIpcWorker>(
+        [this](const hazkey::RequestEnvelope& request, uint64_t traceId) {
+            return sendAndReceive(request, traceId);
+        },
+        eventLoop);
+}
+
 std::optional<hazkey::ResponseEnvelope> HazkeyServerConnector::transact(
     const hazkey::RequestEnvelope& send_data) {
-    std::lock_guard<std::mutex> lock(transact_mutex);
+    HazkeyTraceSpan span("HazkeyServerConnector::transact");
+    // read here: the tracer's current trace belongs to the calling thread
+    uint64_t traceId = HazkeyTracer::instance().currentTraceId();
+    std::optional<hazkey::RequestEnvelope> withInputMode;
+    if (inputModeNeedsSync()) {
+        withInputMode = send_data;
+        attachInputModeState(*withInputMode);
+    }
+    const auto& request = withInputMode ? *withInputMode : send_data;
+    if (worker_ == nullptr) {
+        return sendAndReceive(request, traceId);
+    }
+    return worker_->transact(request, traceId);
+}
+
+void HazkeyServerConnector::postCommand(hazkey::RequestEnvelope request,
+                                        const char* name,
+                                        bool attachInputMode) {
+    auto logFailure =
+        [name](const std::optional<hazkey::ResponseEnvelope>& response) {
+            if (response == std::nullopt) {
+                FCITX_ERROR() << "Error while transacting " << name << "().";
+            } else if (response->status() != hazkey::SUCCESS) {
+                FCITX_ERROR() << name << ": " << "Server returned an error: "
+                              << response->error_message();
+            }
+        };
+    if (attachInputMode) {
+        attachInputModeState(request);
+    }
+    uint64_t traceId = HazkeyTracer::instance().currentTraceId();
+    if (worker_ == nullptr) {
+        logFailure(sendAndReceive(request, traceId));
+        return;
+    }
+    worker_->post(std::move(request), traceId, logFailure);
+}
 
+std::optional<hazkey::ResponseEnvelope> HazkeyServerConnector::sendAndReceive(
+    const hazkey::RequestEnvelope& send_data, uint64_t traceId) {
     if (sock_ == -1) {
         FCITX_INFO() << "Socket not connected, attempting to connect...";
         connectServer();
@@ -184,7 +241,15 @@ std::optional<hazkey::ResponseEnvelope> HazkeyServerConnector::transact(
     }
 
     std::string msg;
-    if (!send_data.SerializeToString(&msg)) {
+    bool serialized;
+    if (HazkeyTracer::instance().enabled() && traceId != 0) {
+        hazkey::RequestEnvelope traced = send_data;
+        traced.set_trace_id(traceId);
+        serialized = traced.SerializeToString(&msg);
+    } else {
+        serialized = send_data.SerializeToString(&msg);
+    }
+    if (!serialized) {
         FCITX_ERROR() << "Failed to serialize protobuf message.";
         return std::nullopt;
     }
@@ -214,6 +279,7 @@ std::optional<hazkey::ResponseEnvelope> HazkeyServerConnector::transact(
     }
 
     FCITX_DEBUG() << "Successfully wrote data to server";
+    requestsSent_.fetch_add(1, std::memory_order_relaxed);
 
     // read response length
     uint32_t readLenBuf;
@@ -312,192 +378,222 @@ void HazkeyServerConnector::inputChar(std::string text) {
     hazkey::RequestEnvelope request;
     auto props = request.mutable_input_char();
     props->set_text(text);
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting inputChar().";
-        return;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "inputChar: " << "Server returned an error: "
-                      << responseVal.error_message();
-        return;
-    }
-    return;
+    // the server applies the state from before these characters
+    attachInputModeState(request);
+    advanceInputMode(text);
+    postCommand(std::move(request), "inputChar", false);
 }
 
 void HazkeyServerConnector::shiftKeyEvent(bool isRelease) {
+    if (!isRelease) {
+        inputModeDirty_ |= !shiftPressedAlone_;
+        shiftPressedAlone_ = true;
+    } else if (shiftPressedAlone_) {
+        subInputMode_ = !subInputMode_;
+        shiftPressedAlone_ = false;
+        inputModeDirty_ = true;
+    }
+}
+
+void HazkeyServerConnector::refreshInputModeInfo() {
     hazkey::RequestEnvelope request;
-    auto props = request.mutable_modifier_event();
-    props->set_event_type(
-        isRelease ? hazkey::commands::ModifierEvent_EventType_RELEASE
-                  : hazkey::commands::ModifierEvent_EventType_PRESS);
-    props->set_mod_type(hazkey::commands::ModifierEvent_ModifierType_SHIFT);
+    request.mutable_get_current_input_mode();
     auto response = transact(request);
     if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting shiftKeyEvent().";
+        FCITX_ERROR() << "Error while transacting refreshInputModeInfo().";
         return;
     }
     auto responseVal = response.value();
     if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "shiftKeyEvent: " << "Server returned an error: "
+        FCITX_ERROR() << "refreshInputModeInfo: "
+                      << "Server returned an error: "
                       << responseVal.error_message();
         return;
     }
-    return;
+    submodeEntryPointChars_ =
+        responseVal.current_input_mode_info().submode_entry_point_chars();
 }
 
-bool HazkeyServerConnector::currentInputModeIsDirect() {
-    hazkey::RequestEnvelope request;
-    auto _ = request.mutable_get_current_input_mode();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting currentInputModeIsDirect().";
-        return false;
+bool HazkeyServerConnector::inputModeNeedsSync() const {
+    // A new connection may be a restarted server with the default state, and
+    // reinitializeConfiguration (e.g. a save in hazkey-settings) resets it
+    // without telling us, so any other state is sent with every command.
+    return inputModeDirty_ || subInputMode_ || shiftPressedAlone_ ||
+           inputModeGeneration_ !=
+               connectionGeneration_.load(std::memory_order_acquire);
+}
+
+void HazkeyServerConnector::attachInputModeState(
+    hazkey::RequestEnvelope& request) {
+    if (!inputModeNeedsSync()) {
+        return;
     }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "currentInputModeIsDirect: "
-                      << "Server returned an error: "
-                      << responseVal.error_message();
-        return false;
+    auto props = request.mutable_input_mode_state();
+    props->set_sub_input_mode(subInputMode_);
+    props->set_shift_pressed_alone(shiftPressedAlone_);
+    inputModeDirty_ = false;
+    inputModeGeneration_ =
+        connectionGeneration_.load(std::memory_order_acquire);
+}
+
+void HazkeyServerConnector::advanceInputMode(const std::string& text) {
+    for (auto iter = text.begin(); iter != text.end();) {
+        auto next = fcitx::utf8::nextChar(iter);
+        if (shiftPressedAlone_ &&
+            submodeEntryPointChars_.find(std::string(iter, next)) !=
+                std::string::npos) {
+            subInputMode_ = true;
+        }
+        shiftPressedAlone_ = false;
+        iter = next;
     }
-    return responseVal.current_input_mode_info().input_mode() ==
-           hazkey::commands::CurrentInputModeInfo::InputMode::
-               CurrentInputModeInfo_InputMode_DIRECT;
 }
 
 void HazkeyServerConnector::deleteLeft() {
     hazkey::RequestEnvelope request;
     request.mutable_delete_left();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting deleteLeft().";
-        return;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "deleteLeft: " << "Server returned an error: "
-                      << responseVal.error_message();
-        return;
-    }
-    return;
+    postCommand(std::move(request), "deleteLeft");
 }
 
 void HazkeyServerConnector::deleteRight() {
     hazkey::RequestEnvelope request;
     request.mutable_delete_right();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting deleteRight().";
-        return;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "deleteRight: " << "Server returned an error: "
-                      << responseVal.error_message();
-        return;
-    }
-    return;
+    postCommand(std::move(request), "deleteRight");
 }
 
 void HazkeyServerConnector::moveCursor(int offset) {
     hazkey::RequestEnvelope request;
     auto props = request.mutable_move_cursor();
     props->set_offset(offset);
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting moveCursor().";
-        return;
+    postCommand(std::move(request), "moveCursor");
+}
+
+namespace {
+
+// 64-bit FNV-1a, computed the same way by hazkey-server
+uint64_t contextHash(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
     }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "moveCursor:" << "Server returned an error: "
-                      << responseVal.error_message();
-        return;
+    return hash;
+}
+
+// Returns the smallest byte offset at which the rest of sent is a prefix of
+// next, or std::string::npos if they do not overlap.
+size_t contextOverlapStart(const std::string& sent, const std::string& next) {
+    for (size_t start = 0; start < sent.size();
+         start = fcitx::utf8::nextChar(sent.begin() + start) - sent.begin()) {
+        if (next.compare(0, sent.size() - start, sent, start,
+                         sent.size() - start) == 0) {
+            return start;
+        }
     }
-    return;
+    return std::string::npos;
 }
 
-void HazkeyServerConnector::setContext(std::string context, int anchor) {
+}  // namespace
+
+void HazkeyServerConnector::setLeftContext(const std::string& leftContext) {
+    uint64_t hash = contextHash(leftContext);
+    // a reconnect means a new server process with an empty context
+    uint64_t generation = connectionGeneration_.load(std::memory_order_acquire);
+    if (contextSynced_ && syncedGeneration_ != generation) {
+        contextSynced_ = false;
+    }
+    if (contextSynced_ && hash == sentContextHash_) {
+        return;
+    }
+
     hazkey::RequestEnvelope request;
     auto props = request.mutable_set_context();
-    props->set_context(context);
-    props->set_anchor(anchor);
+    props->set_context_hash(hash);
+    props->set_window_size(kContextWindowChars);
+    size_t overlapStart = contextSynced_
+                              ? contextOverlapStart(sentContext_, leftContext)
+                              : std::string::npos;
+    bool isDelta = overlapStart != std::string::npos;
+    if (isDelta) {
+        props->set_is_delta(true);
+        props->set_drop_prefix(
+            fcitx::utf8::length(sentContext_, 0, overlapStart));
+        props->set_context(
+            leftContext.substr(sentContext_.size() - overlapStart));
+    } else {
+        props->set_context(leftContext);
+        props->set_anchor(fcitx::utf8::length(leftContext));
+    }
+
+    contextSynced_ = false;
     auto response = transact(request);
     if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting setContext().";
+        FCITX_ERROR() << "Error while transacting setLeftContext().";
         return;
     }
     auto responseVal = response.value();
     if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "setContext:" << "Server returned an error: "
+        FCITX_ERROR() << "setLeftContext:" << "Server returned an error: "
                       << responseVal.error_message();
+        if (isDelta) {
+            // the server lost track of the context, so send all of it
+            setLeftContext(leftContext);
+        }
         return;
     }
-    return;
+    sentContext_ = leftContext;
+    sentContextHash_ = hash;
+    contextSynced_ = true;
+    syncedGeneration_ = generation;
 }
 
 void HazkeyServerConnector::newComposingText() {
+    // the server resets its submode state too
+    subInputMode_ = false;
+    shiftPressedAlone_ = false;
+    inputModeDirty_ = false;
     hazkey::RequestEnvelope request;
     request.mutable_new_composing_text();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR()
-            << "Error while transacting createComposingTextInstance().";
-        return;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "createComposingTextInstance:"
-                      << "Server returned an error: "
-                      << responseVal.error_message();
-        return;
-    }
-    return;
+    postCommand(std::move(request), "createComposingTextInstance");
 }
 
 void HazkeyServerConnector::completePrefix(int index) {
     hazkey::RequestEnvelope request;
     auto props = request.mutable_prefix_complete();
     props->set_index(index);
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting completePrefix().";
-        return;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "completePrefix: " << "Server returned an error: "
-                      << responseVal.error_message();
-        return;
-    }
-    return;
+    postCommand(std::move(request), "completePrefix");
 }
 
 void HazkeyServerConnector::saveLearningData() {
     hazkey::RequestEnvelope request;
     request.mutable_save_learning_data();
+    postCommand(std::move(request), "saveLearningData");
+}
+
+std::string HazkeyServerConnector::flushServerTrace() {
+    hazkey::RequestEnvelope request;
+    request.mutable_flush_trace();
     auto response = transact(request);
     if (response == std::nullopt) {
-        FCITX_ERROR() << "Error while transacting saveLearningData().";
-        return;
+        FCITX_ERROR() << "Error while transacting flushServerTrace().";
+        return "";
     }
     auto responseVal = response.value();
     if (responseVal.status() != hazkey::SUCCESS) {
-        FCITX_ERROR() << "saveLearningData:"
-                      << "Server returned an error: "
+        FCITX_ERROR() << "flushServerTrace: " << "Server returned an error: "
                       << responseVal.error_message();
-        return;
+        return "";
     }
-    return;
+    return responseVal.text();
 }
 
 hazkey::commands::CandidatesResult HazkeyServerConnector::getCandidates(
-    bool isSuggestMode) {
+    bool isSuggestMode, bool paged) {
     hazkey::RequestEnvelope request;
     auto props = request.mutable_get_candidates();
     props->set_is_suggest(isSuggestMode);
+    props->set_paged(paged);
+    props->set_delta_base_version(candidatesBaseVersion());
     auto response = transact(request);
     if (response == std::nullopt) {
         FCITX_ERROR() << "Error while transacting setServerConfig().";
@@ -518,5 +614,210 @@ hazkey::commands::CandidatesResult HazkeyServerConnector::getCandidates(
     //     std::vector<CandidateData> empty_vec;
     //     return hazkey::commands::CandidatesResult();
     // }
-    return responseVal.candidates();
+    auto result = std::move(*responseVal.mutable_candidates());
+    if (!resolveCandidatesDelta(result)) {
+        if (props->delta_base_version() == 0) {
+            return hazkey::commands::CandidatesResult();
+        }
+        // the cached list is out of sync; ask once for the whole list
+        FCITX_DEBUG() << "Requesting the full candidate list.";
+        servedVersion_ = 0;
+        servedCandidates_.Clear();
+        return getCandidates(isSuggestMode, paged);
+    }
+    return result;
+}
+
+uint64_t HazkeyServerConnector::candidatesBaseVersion() const {
+    // a new connection may be a new server that never sent that version
+    if (servedGeneration_ !=
+        connectionGeneration_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    return servedVersion_;
+}
+
+bool HazkeyServerConnector::resolveCandidatesDelta(
+    hazkey::commands::CandidatesResult& result) {
+    using Edit = hazkey::commands::CandidatesResult_Edit;
+    if (!result.is_delta()) {
+        // results not sent as the current list carry no version
+        if (result.version() != 0) {
+            servedCandidates_ = result.candidates();
+            servedVersion_ = result.version();
+            servedGeneration_ =
+                connectionGeneration_.load(std::memory_order_acquire);
+        }
+        return true;
+    }
+    if (result.base_version() != servedVersion_) {
+        // an asynchronous result overtaken by a newer one; the cache
+        // already holds that newer list
+        FCITX_DEBUG() << "Dropping a candidates delta against an old list.";
+        return false;
+    }
+    bool applied = true;
+    for (int i = 0; applied && i < result.edits_size(); i++) {
+        const auto& edit = result.edits(i);
+        int index = edit.index();
+        int size = servedCandidates_.size();
+        switch (edit.op()) {
+            case Edit::INSERT:
+                applied = index >= 0 && index <= size;
+                if (applied) {
+                    *servedCandidates_.Add() = edit.candidate();
+                    for (int j = size; j > index; j--) {
+                        servedCandidates_.SwapElements(j, j - 1);
+                    }
+                }
+                break;
+            case Edit::REMOVE:
+                applied = index >= 0 && index < size;
+                if (applied) {
+                    servedCandidates_.DeleteSubrange(index, 1);
+                }
+                break;
+            case Edit::REPLACE:
+                applied = index >= 0 && index < size;
+                if (applied) {
+                    *servedCandidates_.Mutable(index) = edit.candidate();
+                }
+                break;
+            default:
+                applied = false;
+                break;
+        }
+    }
+    if (!applied) {
+        // the next request asks for the whole list again
+        FCITX_ERROR() << "Candidates delta does not fit the cached list.";
+        servedVersion_ = 0;
+        servedCandidates_.Clear();
+        return false;
+    }
+    servedVersion_ = result.version();
+    *result.mutable_candidates() = servedCandidates_;
+    result.clear_edits();
+    return true;
+}
+
+void HazkeyServerConnector::getCandidatesAsync(
+    bool isSuggest,
+    std::function<void(std::optional<hazkey::commands::CandidatesResult>)>
+        callback) {
+    if (worker_ == nullptr) {
+        callback(getCandidates(isSuggest));
+        return;
+    }
+    hazkey::RequestEnvelope request;
+    auto props = request.mutable_get_candidates();
+    props->set_is_suggest(isSuggest);
+    props->set_delta_base_version(candidatesBaseVersion());
+    attachInputModeState(request);
+    worker_->transactAsync(
+        std::move(request), HazkeyTracer::instance().currentTraceId(),
+        [this, callback = std::move(callback)](
+            std::optional<hazkey::ResponseEnvelope> response) {
+            if (response == std::nullopt) {
+                FCITX_ERROR()
+                    << "Error while transacting getCandidatesAsync().";
+                callback(std::nullopt);
+                return;
+            }
+            if (response->status() != hazkey::SUCCESS) {
+                FCITX_ERROR() << "getCandidatesAsync: "
+                              << "Server returned an error: "
+                              << response->error_message();
+                callback(std::nullopt);
+                return;
+            }
+            auto result = std::move(*response->mutable_candidates());
+            if (!resolveCandidatesDelta(result)) {
+                callback(std::nullopt);
+                return;
+            }
+            callback(std::move(result));
+        });
+}
+
+namespace {
+
+hazkey::RequestEnvelope candidatePageRequest(uint64_t version, int offset,
+                                             int count) {
+    hazkey::RequestEnvelope request;
+    auto props = request.mutable_get_candidate_page();
+    props->set_version(version);
+    props->set_offset(offset);
+    props->set_count(count);
+    return request;
+}
+
+}  // namespace
+
+std::optional<hazkey::commands::CandidatesResult>
+HazkeyServerConnector::getCandidatePage(uint64_t version, int offset,
+                                        int count) {
+    auto response = transact(candidatePageRequest(version, offset, count));
+    if (response == std::nullopt) {
+        FCITX_ERROR() << "Error while transacting getCandidatePage().";
+        return std::nullopt;
+    }
+    auto responseVal = response.value();
+    if (responseVal.status() != hazkey::SUCCESS) {
+        FCITX_ERROR() << "getCandidatePage: " << "Server returned an error: "
+                      << responseVal.error_message();
+        return std::nullopt;
+    }
+    return std::move(*responseVal.mutable_candidates());
+}
+
+void HazkeyServerConnector::getCandidatePageAsync(
+    uint64_t version, int offset, int count,
+    std::function<void(std::optional<hazkey::commands::CandidatesResult>)>
+        callback) {
+    if (worker_ == nullptr) {
+        callback(getCandidatePage(version, offset, count));
+        return;
+    }
+    auto request = candidatePageRequest(version, offset, count);
+    attachInputModeState(request);
+    worker_->transactAsync(
+        std::move(request), HazkeyTracer::instance().currentTraceId(),
+        [callback = std::move(callback)](
+            std::optional<hazkey::ResponseEnvelope> response) {
+            if (response == std::nullopt) {
+                FCITX_ERROR()
+                    << "Error while transacting getCandidatePageAsync().";
+                callback(std::nullopt);
+                return;
+            }
+            if (response->status() != hazkey::SUCCESS) {
+                // the list changed before its pages arrived
+                FCITX_DEBUG() << "getCandidatePageAsync: "
+                              << "Server returned an error: "
+                              << response->error_message();
+                callback(std::nullopt);
+                return;
+            }
+            callback(std::move(*response->mutable_candidates()));
+        });
+}
+
+std::optional<hazkey::commands::ConvertBatchResult>
+HazkeyServerConnector::convertBatch(
+    const hazkey::commands::ConvertBatch& batch) {
+    hazkey::RequestEnvelope request;
+    *request.mutable_convert_batch() = batch;
+    auto response = transact(request);
+    if (response == std::nullopt) {
+        FCITX_ERROR() << "Error while transacting convertBatch().";
+        return std::nullopt;
+    }
+    auto responseVal = response.value();
+    if (responseVal.status() != hazkey::SUCCESS) {
+        FCITX_ERROR() << "convertBatch: " << "Server returned an error: "
+                      << responseVal.error_message();
+        return std::nullopt;
+    }
+    return responseVal.convert_batch_result();
 }
@@ -6,10 +6,16 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
 
 #include "base.pb.h"
 #include "commands.pb.h"
+#include "hazkey_ipc_worker.h"
 
 class HazkeyServerConnector {
    public:
@@ -22,6 +28,18 @@ class HazkeyServerConnector {
         FCITX_DEBUG() << "Connector initialized";
     };
 
+    // Talks to an already connected socket, such as one end of a socketpair,
+    // and never starts or reconnects to hazkey-server.
+    explicit HazkeyServerConnector(int connectedSocket);
+
+    HazkeyServerConnector(const HazkeyServerConnector&) = delete;
+    HazkeyServerConnector& operator=(const HazkeyServerConnector&) = delete;
+
+    // Moves all IPC to a worker thread. Commands without a result are then
+    // pipelined instead of waiting for the server. Without a worker, every
+    // request is sent on the calling thread.
+    void startWorker(fcitx::EventLoop* eventLoop);
+
     std::string getSocketPath();
 
     void connectServer();
@@ -39,9 +57,15 @@ class HazkeyServerConnector {
 
     void inputChar(std::string text);
 
+    // Shift and the submode entry characters drive a copy of the server's
+    // submode state machine, so modifier handling needs no round trip. The
+    // server is told about a change along with the next command.
     void shiftKeyEvent(bool isRelease);
 
-    bool currentInputModeIsDirect();
+    bool currentInputModeIsDirect() const { return subInputMode_; }
+
+    // fetches the submode entry characters of the active profile
+    void refreshInputModeInfo();
 
     void deleteLeft();
 
@@ -49,7 +73,14 @@ class HazkeyServerConnector {
 
     void moveCursor(int offset);
 
-    void setContext(std::string context, int anchor);
+    // Left context kept in sync with the server, in characters. Zenzai
+    // conditions on the text just before the cursor, so a short window keeps
+    // long documents from adding IPC cost per key.
+    static constexpr size_t kContextWindowChars = 64;
+
+    // Sends nothing when leftContext is unchanged and only the difference
+    // when it extends the last one.
+    void setLeftContext(const std::string& leftContext);
 
     void setServerConfig(int zenzaiEnabled, int zenzaiInferLimit,
                          int numberFullwidth, int symbolFullwidth,
@@ -63,19 +94,96 @@ class HazkeyServerConnector {
 
     void saveLearningData();
 
+    // returns the server's buffered trace events and clears them
+    std::string flushServerTrace();
+
     struct CandidateData {
         std::string candidateText;
         std::string subHiragana;
     };
 
-    hazkey::commands::CandidatesResult getCandidates(bool isSuggest);
+    // a paged full conversion returns the first page; total_count tells how
+    // many getCandidatePage can add
+    hazkey::commands::CandidatesResult getCandidates(bool isSuggest,
+                                                     bool paged = false);
+
+    // candidates [offset, offset + count) of the paged result with version
+    std::optional<hazkey::commands::CandidatesResult> getCandidatePage(
+        uint64_t version, int offset, int count);
+
+    // callback runs on the main thread, std::nullopt on failure
+    void getCandidatePageAsync(
+        uint64_t version, int offset, int count,
+        std::function<void(std::optional<hazkey::commands::CandidatesResult>)>
+            callback);
+
+    // callback runs on the main thread, std::nullopt on failure
+    void getCandidatesAsync(
+        bool isSuggest,
+        std::function<void(std::optional<hazkey::commands::CandidatesResult>)>
+            callback);
+
+    std::optional<hazkey::commands::ConvertBatchResult> convertBatch(
+        const hazkey::commands::ConvertBatch& batch);
+
+    // requests written to the server so far, from any thread
+    uint64_t requestsSent() const {
+        return requestsSent_.load(std::memory_order_relaxed);
+    }
 
    private:
     bool retryConnect();
     bool isHazkeyServerRunning();
     bool requestSuccess(hazkey::ResponseEnvelope);
+    std::optional<hazkey::ResponseEnvelope> sendAndReceive(
+        const hazkey::RequestEnvelope& request, uint64_t traceId);
+    // sends a command whose response only matters for error logging;
+    // attachInputMode is false if the caller attached the state itself
+    void postCommand(hazkey::RequestEnvelope request, const char* name,
+                     bool attachInputMode = true);
+    // piggybacks the submode state if the server may not have it
+    void attachInputModeState(hazkey::RequestEnvelope& request);
+    bool inputModeNeedsSync() const;
+    // what the server does with the submode state for each inserted char
+    void advanceInputMode(const std::string& text);
+    // version of servedCandidates_ to ask a delta against, 0 for none
+    uint64_t candidatesBaseVersion() const;
+    // applies a delta-encoded result to servedCandidates_ and fills in its
+    // candidates; false if the delta was against another version
+    bool resolveCandidatesDelta(hazkey::commands::CandidatesResult& result);
     int sock_ = -1;
+    // false for an adopted socket
+    bool canReconnect_ = true;
     std::string socket_path_;
+    // bumped on every new connection, possibly from the worker thread
+    std::atomic<uint64_t> connectionGeneration_{0};
+    std::atomic<uint64_t> requestsSent_{0};
+
+    // what the server holds; valid while syncedGeneration_ is current
+    bool contextSynced_ = false;
+    uint64_t syncedGeneration_ = 0;
+    std::string sentContext_;
+    uint64_t sentContextHash_ = 0;
+
+    // mirror of the server's isSubInputMode / isShiftPressedAlone
+    bool subInputMode_ = false;
+    bool shiftPressedAlone_ = false;
+    // changed by Shift since the server last received it; the server can
+    // only have dropped a non-default state, which is always resent
+    bool inputModeDirty_ = false;
+    uint64_t inputModeGeneration_ = 0;
+    std::string submodeEntryPointChars_ = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    // the candidates of the last current list the server sent, main thread
+    // only
+    google::protobuf::RepeatedPtrField<
+        hazkey::commands::CandidatesResult_Candidate>
+        servedCandidates_;
+    uint64_t servedVersion_ = 0;
+    uint64_t servedGeneration_ = 0;
+
+    // last, so it stops before the members it uses are destroyed
+    std::unique_ptr<HazkeyIpcWorker> worker_;
 };
 
 #endif  // HAZKEY_SERVER_CONNECTOR_H
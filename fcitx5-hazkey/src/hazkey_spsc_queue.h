@@ -0,0 +1,50 @@
+#ifndef HAZKEY_SPSC_QUEUE_H
+#define HAZKEY_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+// Bounded lock-free ring buffer for exactly one producer thread and one
+// consumer thread.
+template <typename T, size_t Capacity>
+class HazkeySpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+   public:
+    // producer only; returns false when the queue is full
+    bool push(T&& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots_[tail & (Capacity - 1)] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    std::optional<T> pop() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        T& slot = slots_[head & (Capacity - 1)];
+        std::optional<T> value(std::move(slot));
+        // release what the moved-from slot still holds before handing it back
+        slot = T();
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+   private:
+    std::array<T, Capacity> slots_;
+    // on separate cache lines so the two threads do not share one
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+#endif  // HAZKEY_SPSC_QUEUE_H
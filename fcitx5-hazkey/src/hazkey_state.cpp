@@ -1,12 +1,15 @@
 #include "hazkey_state.h"
 
+#include <fcitx-utils/event.h>
 #include <fcitx-utils/key.h>
 #include <fcitx-utils/log.h>
+#include <fcitx-utils/utf8.h>
 #include <fcitx/candidatelist.h>
 
 #include <algorithm>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "commands.pb.h"
@@ -14,6 +17,7 @@
 #include "hazkey_candidate.h"
 #include "hazkey_engine.h"
 #include "hazkey_server_connector.h"
+#include "hazkey_trace.h"
 
 namespace fcitx {
 
@@ -33,23 +37,43 @@ bool HazkeyState::isInputableEvent(const KeyEvent& event) {
     return false;
 }
 
-void HazkeyState::commitPreedit() { preedit_.commitPreedit(); }
+void HazkeyState::commitPreedit() {
+    flushPendingInput();
+    preedit_.commitPreedit();
+}
 
 void HazkeyState::keyEvent(KeyEvent& event) {
     FCITX_DEBUG() << "HazkeyState keyEvent";
+    HazkeyTraceSpan span("HazkeyState::keyEvent", true);
 
-    std::string composingText = engine_->server().getComposingText(
-        hazkey::commands::GetComposingString_CharType_HIRAGANA,
-        preedit_.text());
-
+    if (!event.isRelease() && isCoalescableEvent(event)) {
+        queueInput(Key::keySymToUTF8(event.key().sym()));
+        return event.filterAndAccept();
+    }
     if (event.key().sym() == FcitxKey_Shift_L ||
         event.key().sym() == FcitxKey_Shift_R) {
-        engine_->server().shiftKeyEvent(event.isRelease());
-        if (composingText == "") {
-            setAuxDownText(std::nullopt);
-            return;
-        }
+        return shiftKeyEvent(event);
+    }
+    if (!event.isRelease()) {
+        // this key works on the list it sees now, not on one arriving later
+        ++refreshGeneration_;
     }
+    if (event.isRelease() && (!pendingInput_.empty() || suggestionsPending_)) {
+        // releases only refresh the aux text, which the flush updates anyway
+        return;
+    }
+    // every other key sees the composing text with all queued input applied
+    flushPendingInput();
+
+    // A release only picks the aux text, so it goes by the preedit shown
+    // instead of waiting for the server. Presses still read the server's
+    // composing text: the handlers below depend on it.
+    std::string composingText =
+        event.isRelease()
+            ? preedit_.text()
+            : engine_->server().getComposingText(
+                  hazkey::commands::GetComposingString_CharType_HIRAGANA,
+                  preedit_.text());
 
     auto candidateList = std::dynamic_pointer_cast<HazkeyCandidateList>(
         event.inputContext()->inputPanel().candidateList());
@@ -82,6 +106,34 @@ void HazkeyState::keyEvent(KeyEvent& event) {
     }
 }
 
+void HazkeyState::shiftKeyEvent(KeyEvent& event) {
+    // queued input reaches the submode state machine before this Shift
+    flushPendingInputAsync();
+    engine_->server().shiftKeyEvent(event.isRelease());
+
+    if (suggestionsPending_) {
+        // the suggestions redraw the aux text when they arrive
+        if (!event.isRelease()) {
+            event.filterAndAccept();
+        }
+        return;
+    }
+    if (preedit_.text().empty()) {
+        setAuxDownText(std::nullopt);
+        return;
+    }
+    auto candidateList = std::dynamic_pointer_cast<HazkeyCandidateList>(
+        ic_->inputPanel().candidateList());
+    bool listFocused = candidateList != nullptr && candidateList->focused();
+    if (event.isRelease()) {
+        setPreeditAuxDownText(candidateList != nullptr && !listFocused);
+    } else if (listFocused) {
+        event.filter();
+    } else {
+        event.filterAndAccept();
+    }
+}
+
 void HazkeyState::noPreeditKeyEvent(KeyEvent& event) {
     FCITX_DEBUG() << "HazkeyState noPredictKeyEvent";
 
@@ -208,6 +260,93 @@ void HazkeyState::preeditKeyEvent(
     return event.filterAndAccept();
 }
 
+bool HazkeyState::isCoalescableEvent(const KeyEvent& event) {
+    auto key = event.key();
+    if (key.sym() == FcitxKey_space || isDirectConversionMode_ ||
+        key.states().testAny(
+            KeyStates{KeyState::Ctrl, KeyState::Alt, KeyState::Super}) ||
+        !isInputableEvent(event)) {
+        return false;
+    }
+    // selection keys and commit-and-continue input need the candidate list
+    auto candidateList = std::dynamic_pointer_cast<HazkeyCandidateList>(
+        ic_->inputPanel().candidateList());
+    return candidateList == nullptr || !candidateList->focused();
+}
+
+void HazkeyState::queueInput(const std::string& text) {
+    if (pendingInput_.empty()) {
+        pendingInputStartsComposition_ = preedit_.text().empty();
+    }
+    pendingInput_ += text;
+    if (flushEvent_ != nullptr) {
+        return;
+    }
+    // Keys already waiting in the frontend are dispatched before this timer
+    // fires, so a burst typed during a slow conversion lands in one flush.
+    auto& eventLoop = engine_->instance()->eventLoop();
+    flushEvent_ = eventLoop.addTimeEvent(
+        CLOCK_MONOTONIC, now(CLOCK_MONOTONIC), 0,
+        [this](EventSourceTime*, uint64_t) {
+            flushPendingInputAsync();
+            return true;
+        });
+}
+
+bool HazkeyState::sendPendingInput() {
+    // destroying the event source from its own callback is allowed
+    flushEvent_.reset();
+    if (pendingInput_.empty()) {
+        return false;
+    }
+    std::string input = std::move(pendingInput_);
+    pendingInput_.clear();
+
+    if (pendingInputStartsComposition_) {
+        updateSurroundingText();
+    }
+    // the server inserts every character of the batch
+    engine_->server().inputChar(input);
+    return true;
+}
+
+void HazkeyState::flushPendingInput() {
+    HazkeyTraceSpan span("HazkeyState::flushPendingInput", true);
+    if (!sendPendingInput() && !suggestionsPending_) {
+        return;
+    }
+    suggestionsPending_ = false;
+    showPreeditCandidateList();
+    setHiraganaAUX();
+}
+
+void HazkeyState::flushPendingInputAsync() {
+    HazkeyTraceSpan span("HazkeyState::flushPendingInputAsync", true);
+    if (!sendPendingInput()) {
+        return;
+    }
+    // the suggestions are applied when they arrive, unless another key or a
+    // reset needed them first
+    suggestionsPending_ = true;
+    uint64_t generation = refreshGeneration_;
+    auto icRef = ic_->watch();
+    engine_->server().getCandidatesAsync(
+        true,
+        [this, icRef, generation](
+            std::optional<hazkey::commands::CandidatesResult> response) {
+            if (!icRef.isValid() || generation != refreshGeneration_ ||
+                response == std::nullopt) {
+                return;
+            }
+            HazkeyTraceSpan span("HazkeyState::applySuggestions", true);
+            suggestionsPending_ = false;
+            setPreeditAuxDownText(applyCandidateList(std::move(*response)));
+            setHiraganaAUX();
+            ic_->updatePreedit();
+            ic_->updateUserInterface(UserInterfaceComponent::InputPanel);
+        });
+}
+
 bool HazkeyState::isAltDigitKeyEvent(const KeyEvent& event) {
     auto key = event.key();
     if (key.states() == KeyState::Alt && key.sym() >= FcitxKey_1 &&
@@ -225,6 +364,39 @@ void HazkeyState::candidateKeyEvent(
     auto keysym = key.sym();
 
     std::vector<std::string> preedit;
+    // Only a move past the loaded candidates waits for the rest; within
+    // them, the prefetch started with the list fills it in meanwhile.
+    int cursor = candidateList->globalCursorIndex();
+    int loaded = candidateList->totalSize();
+    bool needsRemaining = false;
+    switch (keysym) {
+        case FcitxKey_Right:
+            // the first candidate of the next page
+            needsRemaining = (candidateList->currentPage() + 1) *
+                                 candidateList->pageSize() >=
+                             loaded;
+            break;
+        case FcitxKey_space:
+        case FcitxKey_Tab:
+            if (key.states() == KeyState::Shift) {
+                // wraps from the first candidate to the last
+                needsRemaining = cursor == 0;
+            } else if (key.states() != KeyState::Alt_Shift) {
+                needsRemaining = cursor + 1 >= loaded;
+            }
+            break;
+        case FcitxKey_Down:
+            needsRemaining = cursor + 1 >= loaded;
+            break;
+        case FcitxKey_Up:
+            needsRemaining = cursor == 0;
+            break;
+        default:
+            break;
+    }
+    if (needsRemaining) {
+        loadRemainingCandidates(candidateList);
+    }
     switch (keysym) {
         case FcitxKey_Right:
             // if (event.key().states() == KeyState::Alt) {
@@ -313,15 +485,28 @@ void HazkeyState::candidateCompleteHandler(
 }
 
 void HazkeyState::updateSurroundingText(std::string appendText) {
+    constexpr size_t window = HazkeyServerConnector::kContextWindowChars;
+    std::string leftContext;
     if (ic_->capabilityFlags().test(CapabilityFlag::SurroundingText) &&
         ic_->surroundingText().isValid()) {
-        auto& surroundingText = ic_->surroundingText();
-        engine_->server().setContext(
-            surroundingText.text() + appendText,
-            surroundingText.anchor() + appendText.length());
-    } else {
-        engine_->server().setContext("", 0);
+        // only the window before the cursor; the text can be a whole document
+        const auto& surroundingText = ic_->surroundingText();
+        const auto& text = surroundingText.text();
+        size_t cursor = std::min<size_t>(surroundingText.cursor(),
+                                         utf8::length(text));
+        size_t start = cursor > window ? cursor - window : 0;
+        size_t startByte = utf8::ncharByteLength(text.begin(), start);
+        size_t length =
+            utf8::ncharByteLength(text.begin() + startByte, cursor - start);
+        leftContext = text.substr(startByte, length) + appendText;
+
+        size_t chars = utf8::length(leftContext);
+        if (chars > window) {
+            leftContext.erase(
+                0, utf8::ncharByteLength(leftContext.begin(), chars - window));
+        }
     }
+    engine_->server().setLeftContext(leftContext);
 }
 
 bool HazkeyState::ctrlShortcutHandler(KeyEvent& event) {
@@ -429,14 +614,23 @@ void HazkeyState::directCharactorConversion(ConversionMode mode) {
 bool HazkeyState::showCandidateList(bool isSuggest) {
     FCITX_DEBUG() << "HazkeyState showCandidateList";
 
-    auto response = engine_->server().getCandidates(isSuggest);
-
-    auto candidateResult =
-        std::make_unique<HazkeyCandidateList>(std::move(response.candidates()));
+    // a full conversion is shown with its first page; the rest is loaded
+    // while that page is shown
+    return applyCandidateList(
+        engine_->server().getCandidates(isSuggest, !isSuggest));
+}
 
-    candidateResult->setSelectionKey(defaultSelectionKeys);
+bool HazkeyState::applyCandidateList(
+    hazkey::commands::CandidatesResult response) {
+    auto& inputPanel = ic_->inputPanel();
+    auto candidateList = std::dynamic_pointer_cast<HazkeyCandidateList>(
+        inputPanel.candidateList());
 
-    ic_->inputPanel().reset();
+    // what inputPanel().reset() clears, except the list, which is reused
+    inputPanel.setPreedit(Text());
+    inputPanel.setClientPreedit(Text());
+    inputPanel.setAuxUp(Text());
+    inputPanel.setAuxDown(Text());
 
     // TODO: check live preedit config
     if (!response.live_text().empty()) {
@@ -455,13 +649,22 @@ bool HazkeyState::showCandidateList(bool isSuggest) {
     livePreeditIndex_ = response.live_text_index();
 
     if (response.page_size() > 0) {
-        ic_->inputPanel().setCandidateList(std::move(candidateResult));
-        auto newFcitxCandidateList =
-            std::dynamic_pointer_cast<HazkeyCandidateList>(
-                ic_->inputPanel().candidateList());
+        if (candidateList != nullptr) {
+            candidateList->update(response.mutable_candidates());
+        } else {
+            auto newCandidateList = std::make_unique<HazkeyCandidateList>(
+                response.mutable_candidates());
+            newCandidateList->setSelectionKey(defaultSelectionKeys);
+            inputPanel.setCandidateList(std::move(newCandidateList));
+            candidateList = std::dynamic_pointer_cast<HazkeyCandidateList>(
+                inputPanel.candidateList());
+        }
         int pageSize = std::min(static_cast<size_t>(response.page_size()),
                                 defaultSelectionKeys.size());
-        newFcitxCandidateList->setPageSize(pageSize);
+        candidateList->setPageSize(pageSize);
+        candidateList->setPaging(response.version(), response.total_count());
+    } else if (candidateList != nullptr) {
+        inputPanel.setCandidateList(nullptr);
     }
 
     // true if the list is displayed
@@ -480,10 +683,59 @@ void HazkeyState::showNonPredictCandidateList() {
 
     auto newCandidateList = std::dynamic_pointer_cast<HazkeyCandidateList>(
         ic_->inputPanel().candidateList());
+    if (newCandidateList == nullptr) {
+        // the server failed or returned no candidates
+        return;
+    }
     newCandidateList->focus();
     updateCandidateCursor(newCandidateList);
     setCandidateCursorAUX(
         std::static_pointer_cast<HazkeyCandidateList>(newCandidateList));
+    prefetchCandidates(newCandidateList);
+}
+
+void HazkeyState::prefetchCandidates(
+    std::shared_ptr<HazkeyCandidateList> candidateList) {
+    if (candidateList == nullptr || candidateList->fullyLoaded()) {
+        return;
+    }
+    uint64_t version = candidateList->pagingVersion();
+    int offset = candidateList->totalSize();
+    std::weak_ptr<HazkeyCandidateList> weakList = candidateList;
+    auto icRef = ic_->watch();
+    engine_->server().getCandidatePageAsync(
+        version, offset, candidateList->fullSize() - offset,
+        [this, icRef, weakList, version, offset](
+            std::optional<hazkey::commands::CandidatesResult> page) {
+            auto list = weakList.lock();
+            // the list may have been loaded on demand or replaced meanwhile
+            if (!icRef.isValid() || list == nullptr || page == std::nullopt ||
+                list->pagingVersion() != version ||
+                list->totalSize() != offset) {
+                return;
+            }
+            list->appendCandidates(page->mutable_candidates());
+            if (ic_->inputPanel().candidateList() == list) {
+                ic_->updateUserInterface(UserInterfaceComponent::InputPanel);
+            }
+        });
+}
+
+void HazkeyState::loadRemainingCandidates(
+    std::shared_ptr<HazkeyCandidateList> candidateList) {
+    if (candidateList->fullyLoaded()) {
+        return;
+    }
+    int offset = candidateList->totalSize();
+    auto page = engine_->server().getCandidatePage(
+        candidateList->pagingVersion(), offset,
+        candidateList->fullSize() - offset);
+    if (page == std::nullopt) {
+        // keep what is loaded instead of asking again on every key
+        candidateList->setPaging(candidateList->pagingVersion(), offset);
+        return;
+    }
+    candidateList->appendCandidates(page->mutable_candidates());
 }
 
 void HazkeyState::showPreeditCandidateList() {
@@ -495,7 +747,11 @@ void HazkeyState::showPreeditCandidateList() {
         reset();
         return;
     }
-    if (showCandidateList(true) && engine_->config().showTabToSelect.value()) {
+    setPreeditAuxDownText(showCandidateList(true));
+}
+
+void HazkeyState::setPreeditAuxDownText(bool listShown) {
+    if (listShown && engine_->config().showTabToSelect.value()) {
         setAuxDownText(std::string(_("[Press Tab to Select]")));
     } else {
         setAuxDownText(std::nullopt);
@@ -529,7 +785,7 @@ void HazkeyState::backCandidateCursor(
 void HazkeyState::setCandidateCursorAUX(
     std::shared_ptr<HazkeyCandidateList> candidateList) {
     auto label = "[" + std::to_string(candidateList->globalCursorIndex() + 1) +
-                 "/" + std::to_string(candidateList->totalSize()) + "]";
+                 "/" + std::to_string(candidateList->fullSize()) + "]";
     ic_->inputPanel().setAuxUp(Text(label));
     setAuxDownText(std::nullopt);
 }
@@ -554,6 +810,10 @@ void HazkeyState::setHiraganaAUX() {
 
 void HazkeyState::reset() {
     FCITX_DEBUG() << "HazkeyState reset";
+    flushEvent_.reset();
+    pendingInput_.clear();
+    ++refreshGeneration_;
+    suggestionsPending_ = false;
     isDirectConversionMode_ = false;
     livePreeditIndex_ = -1;
     isCursorMoving_ = false;
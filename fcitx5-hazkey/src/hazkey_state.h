@@ -1,10 +1,16 @@
 #ifndef _FCITX5_HAZKEY_HAZKEY_STATE_H_
 #define _FCITX5_HAZKEY_HAZKEY_STATE_H_
 
+#include <fcitx-utils/event.h>
 #include <fcitx/inputcontext.h>
 #include <fcitx/inputpanel.h>
 #include <fcitx/surroundingtext.h>
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "commands.pb.h"
 #include "hazkey_candidate.h"
 #include "hazkey_preedit.h"
 
@@ -26,6 +32,10 @@ class HazkeyState : public InputContextProperty {
     // void loadConfig(std::shared_ptr<HazkeyConfig> &config);
     //  reset to the initial state
     void reset();
+    // queued input or suggestions not shown in the input panel yet
+    bool hasPendingWork() const {
+        return !pendingInput_.empty() || suggestionsPending_;
+    }
 
    private:
     enum class ConversionMode {
@@ -41,7 +51,7 @@ class HazkeyState : public InputContextProperty {
         NonPredictWithFirstPreedit,
     };
 
-    // update surrounding text
+    // send the text before the cursor, plus appendText, as the left context
     void updateSurroundingText(std::string appendText = "");
 
     bool ctrlShortcutHandler(KeyEvent& keyEvent);
@@ -49,6 +59,8 @@ class HazkeyState : public InputContextProperty {
     void functionKeyHandler(KeyEvent& keyEvent);
     // convert to hiragana/katakana/alphanumeric directly
     void directCharactorConversion(ConversionMode mode);
+    // handle Shift press and release without a server round trip
+    void shiftKeyEvent(KeyEvent& keyEvent);
     // handle key event in normal mode (no preedit)
     void noPreeditKeyEvent(KeyEvent& keyEvent);
     // handle key event in candidate mode
@@ -61,12 +73,19 @@ class HazkeyState : public InputContextProperty {
     // base function to prepare candidate list
     // make sure composingText_ is not nullptr
     bool showCandidateList(bool isSuggest);
+    // show a candidate list the server already returned
+    bool applyCandidateList(hazkey::commands::CandidatesResult response);
     std::unique_ptr<HazkeyCandidateList> createCandidateList(
         std::vector<std::vector<std::string>> candidates,
         std::shared_ptr<std::vector<std::string>> preeditSegments);
 
     // prepare candidate list for normal conversion
     void showNonPredictCandidateList();
+    // load the candidates past the first page in the background
+    void prefetchCandidates(std::shared_ptr<HazkeyCandidateList> candidateList);
+    // load them now, unless the prefetch already did
+    void loadRemainingCandidates(
+        std::shared_ptr<HazkeyCandidateList> candidateList);
     // prepare candidate
     // list for prediction.
     // shorter than normal
@@ -95,6 +114,8 @@ class HazkeyState : public InputContextProperty {
     // set AuxDown
     // like "[Tabキーで選択]" or "[直接入力]"
     void setAuxDownText(std::optional<std::string>);
+    // AuxDown under the live suggestions
+    void setPreeditAuxDownText(bool listShown);
     // UpAUX that shows unconverted text
     void setHiraganaAUX();
     // check if the key
@@ -105,9 +126,36 @@ class HazkeyState : public InputContextProperty {
 
     bool isAltDigitKeyEvent(const KeyEvent& keyEvent);
 
+    // check if the key event only appends a character to the composing text
+    // and can be queued behind other pending input
+    bool isCoalescableEvent(const KeyEvent& keyEvent);
+    // queue an input character; sent by flushPendingInput()
+    void queueInput(const std::string& text);
+    // send queued input characters and request candidates once for the
+    // newest composing text
+    void flushPendingInput();
+    // same, but applies the candidates when the IPC worker delivers them
+    // instead of waiting; used when nothing else depends on them
+    void flushPendingInputAsync();
+    // send queued input characters; false if there were none
+    bool sendPendingInput();
+
     bool isCursorMoving_ = false;
 
     bool isDirectConversionMode_ = false;
+    // input characters not sent to the server yet. Keys that arrive while a
+    // conversion is in flight are queued here and sent together, so that
+    // only the newest composing text is converted.
+    std::string pendingInput_;
+    // the composing text was empty when pendingInput_ started
+    bool pendingInputStartsComposition_ = false;
+    std::unique_ptr<EventSourceTime> flushEvent_;
+    // bumped on non-input key presses and reset; suggestions requested under
+    // an older value are dropped when they arrive
+    uint64_t refreshGeneration_ = 0;
+    // flushPendingInputAsync() sent input whose suggestions are not shown
+    // yet; flushPendingInput() then fetches them synchronously
+    bool suggestionsPending_ = false;
     int livePreeditIndex_ = -1;
     // engine
     HazkeyEngine* engine_;
@@ -0,0 +1,126 @@
+#include "hazkey_trace.h"
+
+#include <fcitx-utils/log.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+HazkeyTracer& HazkeyTracer::instance() {
+    static HazkeyTracer tracer;
+    return tracer;
+}
+
+HazkeyTracer::HazkeyTracer() {
+    const char* env = std::getenv("HAZKEY_TRACE");
+    enabled_ = env != nullptr && env[0] != '\0' && std::string(env) != "0";
+    if (enabled_) {
+        spans_.reserve(kCapacity);
+        FCITX_INFO() << "Tracing enabled";
+    }
+}
+
+uint64_t HazkeyTracer::nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 +
+           static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+uint64_t HazkeyTracer::nextTraceId() {
+    // keep IDs unique across addon restarts within one trace file
+    return (static_cast<uint64_t>(getpid()) << 32) | ++traceCounter_;
+}
+
+void HazkeyTracer::record(const char* name, uint64_t traceId,
+                          uint64_t startUs, uint64_t durationUs) {
+    if (!enabled_) {
+        return;
+    }
+    Span span{name, traceId, startUs, durationUs,
+              static_cast<int>(syscall(SYS_gettid))};
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (spans_.size() < kCapacity) {
+        spans_.push_back(span);
+    } else {
+        spans_[nextIndex_] = span;
+    }
+    nextIndex_ = (nextIndex_ + 1) % kCapacity;
+}
+
+std::string HazkeyTracer::flush(const std::string& serverEvents) {
+    if (!enabled_) {
+        return "";
+    }
+
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    std::string path = std::string(runtimeDir ? runtimeDir : "/tmp") +
+                       "/hazkey-trace." + std::to_string(getpid()) + "." +
+                       std::to_string(nowUs()) + ".json";
+
+    std::ofstream out(path);
+    if (!out) {
+        FCITX_ERROR() << "Failed to open trace file: " << path;
+        return "";
+    }
+
+    int pid = getpid();
+    bool first = true;
+    out << "{\"traceEvents\":[\n";
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // oldest first
+        size_t start = spans_.size() < kCapacity ? 0 : nextIndex_;
+        for (size_t i = 0; i < spans_.size(); ++i) {
+            const Span& span = spans_[(start + i) % spans_.size()];
+            out << (first ? "" : ",\n") << "{\"name\":\"" << span.name
+                << "\",\"cat\":\"hazkey\",\"ph\":\"X\",\"ts\":" << span.startUs
+                << ",\"dur\":" << span.durationUs << ",\"pid\":" << pid
+                << ",\"tid\":" << span.tid << ",\"args\":{\"trace_id\":"
+                << span.traceId << "}}";
+            first = false;
+        }
+        spans_.clear();
+        nextIndex_ = 0;
+    }
+    if (!serverEvents.empty()) {
+        out << (first ? "" : ",\n") << serverEvents;
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    out.close();
+
+    if (!out) {
+        FCITX_ERROR() << "Failed to write trace file: " << path;
+        return "";
+    }
+    FCITX_INFO() << "Trace written to " << path;
+    return path;
+}
+
+HazkeyTraceSpan::HazkeyTraceSpan(const char* name, bool newTrace)
+    : name_(name) {
+    auto& tracer = HazkeyTracer::instance();
+    if (!tracer.enabled()) {
+        return;
+    }
+    if (newTrace && tracer.currentTraceId_ == 0) {
+        tracer.currentTraceId_ = tracer.nextTraceId();
+        ownsTrace_ = true;
+    }
+    startUs_ = HazkeyTracer::nowUs();
+}
+
+HazkeyTraceSpan::~HazkeyTraceSpan() {
+    auto& tracer = HazkeyTracer::instance();
+    if (!tracer.enabled()) {
+        return;
+    }
+    tracer.record(name_, tracer.currentTraceId_, startUs_,
+                  HazkeyTracer::nowUs() - startUs_);
+    if (ownsTrace_) {
+        tracer.currentTraceId_ = 0;
+    }
+}
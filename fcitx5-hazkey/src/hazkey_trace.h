@@ -0,0 +1,74 @@
+#ifndef HAZKEY_TRACE_H
+#define HAZKEY_TRACE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Opt-in span recorder enabled by the HAZKEY_TRACE environment variable.
+// hazkey-server inherits the variable and records its own spans under the
+// same trace IDs; flush() merges both into one Chrome trace JSON file.
+class HazkeyTracer {
+   public:
+    static HazkeyTracer& instance();
+
+    bool enabled() const { return enabled_; }
+
+    // trace ID of the keystroke being handled, 0 outside of a trace
+    uint64_t currentTraceId() const { return currentTraceId_; }
+
+    // CLOCK_MONOTONIC in microseconds, shared with hazkey-server
+    static uint64_t nowUs();
+
+    void record(const char* name, uint64_t traceId, uint64_t startUs,
+                uint64_t durationUs);
+
+    // Writes buffered spans and serverEvents (comma-separated trace event
+    // objects) to $XDG_RUNTIME_DIR and clears the buffer.
+    // Returns the path of the written file, or an empty string on failure.
+    std::string flush(const std::string& serverEvents);
+
+   private:
+    friend class HazkeyTraceSpan;
+
+    struct Span {
+        const char* name;
+        uint64_t traceId;
+        uint64_t startUs;
+        uint64_t durationUs;
+        int tid;
+    };
+
+    static constexpr size_t kCapacity = 8192;
+
+    HazkeyTracer();
+
+    uint64_t nextTraceId();
+
+    bool enabled_ = false;
+    uint64_t currentTraceId_ = 0;
+    uint64_t traceCounter_ = 0;
+
+    std::mutex mutex_;
+    std::vector<Span> spans_;
+    size_t nextIndex_ = 0;
+};
+
+// Records the enclosing scope as a span. With newTrace, a fresh trace ID is
+// assigned for the scope unless one is already active.
+class HazkeyTraceSpan {
+   public:
+    explicit HazkeyTraceSpan(const char* name, bool newTrace = false);
+    ~HazkeyTraceSpan();
+
+    HazkeyTraceSpan(const HazkeyTraceSpan&) = delete;
+    HazkeyTraceSpan& operator=(const HazkeyTraceSpan&) = delete;
+
+   private:
+    const char* name_;
+    uint64_t startUs_ = 0;
+    bool ownsTrace_ = false;
+};
+
+#endif  // HAZKEY_TRACE_H
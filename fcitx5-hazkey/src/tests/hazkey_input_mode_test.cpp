@@ -0,0 +1,147 @@
+// hazkey-input-mode-test: checks the submode state HazkeyServerConnector
+// piggybacks on its commands, against a fake server on a socketpair that
+// records what it receives. Exits non-zero on the first mismatch.
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "base.pb.h"
+#include "commands.pb.h"
+#include "hazkey_server_connector.h"
+#include "tools/hazkey_fake_server.h"
+
+namespace {
+
+// the input_mode_state of each request, nullopt if it had none
+class RecordingServer : public HazkeyFakeServer {
+   public:
+    RecordingServer() : HazkeyFakeServer(Options{}) {}
+
+    hazkey::ResponseEnvelope respond(
+        const hazkey::RequestEnvelope& request) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (request.has_input_mode_state()) {
+            states_.push_back(request.input_mode_state());
+        } else {
+            states_.push_back(std::nullopt);
+        }
+        return HazkeyFakeServer::respond(request);
+    }
+
+    std::optional<hazkey::commands::InputModeState> last() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return states_.empty() ? std::nullopt : states_.back();
+    }
+
+   private:
+    std::mutex mutex_;
+    std::vector<std::optional<hazkey::commands::InputModeState>> states_;
+};
+
+class RecordingServerPair {
+   public:
+    RecordingServerPair() {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            std::perror("socketpair");
+            std::exit(1);
+        }
+        clientFd_ = fds[0];
+        serverFd_ = fds[1];
+        thread_ = std::thread([this]() { server_.serve(serverFd_); });
+    }
+
+    ~RecordingServerPair() {
+        close(clientFd_);
+        thread_.join();
+        close(serverFd_);
+    }
+
+    int clientFd() const { return clientFd_; }
+    RecordingServer& server() { return server_; }
+
+   private:
+    RecordingServer server_;
+    int clientFd_ = -1;
+    int serverFd_ = -1;
+    std::thread thread_;
+};
+
+int failures = 0;
+
+void expectState(const char* step,
+                 const std::optional<hazkey::commands::InputModeState>& state,
+                 bool subInputMode, bool shiftPressedAlone) {
+    if (state == std::nullopt) {
+        std::fprintf(stderr, "FAIL %s: no input_mode_state sent\n", step);
+        ++failures;
+        return;
+    }
+    if (state->sub_input_mode() != subInputMode ||
+        state->shift_pressed_alone() != shiftPressedAlone) {
+        std::fprintf(stderr,
+                     "FAIL %s: sent sub_input_mode=%d shift_pressed_alone=%d, "
+                     "expected %d %d\n",
+                     step, state->sub_input_mode(),
+                     state->shift_pressed_alone(), subInputMode,
+                     shiftPressedAlone);
+        ++failures;
+    }
+}
+
+// Shift then an entry-point character: the server has to see the state from
+// before the character, or it never enters the submode.
+void testShiftThenEntryPointChar() {
+    RecordingServerPair pair;
+    HazkeyServerConnector server(pair.clientFd());
+    // the fake server's entry-point characters are A-Z
+    server.refreshInputModeInfo();
+
+    server.shiftKeyEvent(false);
+    server.inputChar("A");
+    expectState("inputChar after Shift", pair.server().last(), false, true);
+
+    server.deleteLeft();
+    expectState("command after entering the submode", pair.server().last(),
+                true, false);
+}
+
+// A plain character leaves the state as it was, so it only goes out while
+// the server may not have it.
+void testPlainCharAfterShift() {
+    RecordingServerPair pair;
+    HazkeyServerConnector server(pair.clientFd());
+    server.refreshInputModeInfo();
+
+    server.shiftKeyEvent(false);
+    server.inputChar("a");
+    expectState("plain inputChar after Shift", pair.server().last(), false,
+                true);
+
+    server.deleteLeft();
+    if (pair.server().last() != std::nullopt) {
+        std::fprintf(stderr,
+                     "FAIL command in the default state: input_mode_state "
+                     "sent again\n");
+        ++failures;
+    }
+}
+
+}  // namespace
+
+int main() {
+    testShiftThenEntryPointChar();
+    testPlainCharAfterShift();
+    if (failures != 0) {
+        return 1;
+    }
+    std::printf("hazkey-input-mode-test: all passed\n");
+    return 0;
+}
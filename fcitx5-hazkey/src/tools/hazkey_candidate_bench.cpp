@@ -0,0 +1,178 @@
+// hazkey-candidate-bench: counts the heap allocations made per key when the
+// live suggestions are put into a candidate list, either by building a new
+// list for every key as the addon used to, copying every candidate, or by
+// updating one HazkeyCandidateList in place.
+//
+// Output (stdout, tsv):
+//   mode<TAB>keys<TAB>allocations_per_key<TAB>bytes_per_key
+
+#include <fcitx/candidatelist.h>
+#include <fcitx/text.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "commands.pb.h"
+#include "hazkey_candidate.h"
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> allocatedBytes{0};
+
+struct Options {
+    int keys = 1000;
+    int listSize = 9;
+    // candidates at the tail of the list that stay the same between keys
+    int stable = 4;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "Count allocations per key of candidate list updates.\n\n"
+              << "  -k, --keys N       simulated key presses (default: 1000)\n"
+              << "  -s, --size N       candidates per list (default: 9)\n"
+              << "  -t, --stable N     unchanged candidates per key "
+                 "(default: 4)\n"
+              << "  -h, --help         show this help\n";
+}
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        int* target = nullptr;
+        if (arg == "-k" || arg == "--keys") {
+            target = &options.keys;
+        } else if (arg == "-s" || arg == "--size") {
+            target = &options.listSize;
+        } else if (arg == "-t" || arg == "--stable") {
+            target = &options.stable;
+        } else {
+            return false;
+        }
+        if (value == nullptr || (*target = std::atoi(value)) < 0) {
+            return false;
+        }
+        ++i;
+    }
+    return options.keys > 0 && options.stable <= options.listSize;
+}
+
+// the suggestions after the key-th key: the head follows the reading, the
+// tail is the same for every key
+hazkey::commands::CandidatesResult makeResponse(const Options& options,
+                                                int key) {
+    hazkey::commands::CandidatesResult response;
+    int changing = options.listSize - options.stable;
+    for (int i = 0; i < options.listSize; ++i) {
+        auto* candidate = response.add_candidates();
+        if (i < changing) {
+            candidate->set_text("候補候補候補" + std::to_string(key) + "-" +
+                                std::to_string(i));
+            candidate->set_sub_hiragana("こうほ" + std::to_string(key));
+        } else {
+            candidate->set_text("定型の候補" + std::to_string(i));
+        }
+    }
+    response.set_page_size(options.listSize);
+    return response;
+}
+
+// HazkeyCandidateWord before in-place updates. The message was taken by
+// value and its strings copied out of it, as moving from const copies.
+class CopyingCandidateWord : public fcitx::CandidateWord {
+   public:
+    explicit CopyingCandidateWord(
+        const hazkey::commands::CandidatesResult_Candidate data)
+        : CandidateWord(fcitx::Text(data.text())),
+          candidate_(std::move(data.text())),
+          hiragana_(std::move(data.sub_hiragana())) {
+        setText(fcitx::Text(data.text()));
+    }
+
+    void select(fcitx::InputContext*) const override {}
+
+   private:
+    const std::string candidate_;
+    const std::string hiragana_;
+};
+
+// HazkeyCandidateList's constructor before in-place updates: the field was
+// passed by value, so the response's candidates were copied once more
+std::unique_ptr<fcitx::CommonCandidateList> buildCopyingList(
+    fcitx::CandidateField candidates) {
+    auto list = std::make_unique<fcitx::CommonCandidateList>();
+    for (const auto& candidate : candidates) {
+        list->append(std::make_unique<CopyingCandidateWord>(candidate));
+    }
+    return list;
+}
+
+void report(const char* mode, const Options& options) {
+    std::cout << mode << "\t" << options.keys << "\t"
+              << static_cast<double>(allocations) / options.keys << "\t"
+              << static_cast<double>(allocatedBytes) / options.keys << "\n";
+}
+
+template <typename Step>
+void run(const char* mode, const Options& options, Step step) {
+    allocations = 0;
+    allocatedBytes = 0;
+    for (int key = 0; key < options.keys; ++key) {
+        // only the list update is counted, not building the response
+        auto response = makeResponse(options, key);
+        counting = true;
+        step(response);
+        counting = false;
+    }
+    report(mode, options);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<fcitx::CommonCandidateList> rebuilt;
+    run("rebuild", options,
+        [&](hazkey::commands::CandidatesResult& response) {
+            rebuilt = buildCopyingList(response.candidates());
+            rebuilt->setPageSize(response.page_size());
+        });
+
+    auto updateResponse = makeResponse(options, -1);
+    fcitx::HazkeyCandidateList updated(updateResponse.mutable_candidates());
+    run("update", options, [&](hazkey::commands::CandidatesResult& response) {
+        updated.update(response.mutable_candidates());
+        updated.setPageSize(response.page_size());
+    });
+    return 0;
+}
@@ -0,0 +1,510 @@
+// hazkey-convert: streams readings through hazkey-server's ConvertBatch
+// request for offline throughput tests and regression corpora.
+//
+// hazkey-server serves one client at a time and handles a batch in one go,
+// so hazkey-convert never uses the addon's server: by default it starts a
+// private hazkey-server in a temporary XDG_RUNTIME_DIR and stops it at exit.
+// --socket uses a server started the same way instead.
+//
+// Input (one item per line, from a file or stdin):
+//   tsv:   reading[<TAB>left_context]
+//   jsonl: {"reading": "...", "left_context": "..."}
+// Output (stdout):
+//   tsv:   reading<TAB>candidate1<TAB>candidate2...
+//   jsonl: {"reading":"...","candidates":["...",...]}
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "commands.pb.h"
+#include "hazkey_server_connector.h"
+#include "hazkey_tool_util.h"
+
+namespace {
+
+enum class Format { Tsv, Jsonl };
+
+struct Options {
+    Format format = Format::Tsv;
+    int nBest = 10;
+    int batchSize = 64;
+    bool useZenzai = false;
+    std::string inputPath;
+    std::string socketPath;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr
+        << "Usage: " << argv0 << " [options] [INPUT]\n"
+        << "Convert readings with hazkey-server. Reads stdin if INPUT is "
+           "omitted.\n\n"
+        << "  -f, --format tsv|jsonl  input and output format (default: tsv)\n"
+        << "  -n, --n-best N          candidates per reading (default: 10)\n"
+        << "  -b, --batch-size N      readings per request (default: 64)\n"
+        << "  -z, --zenzai            convert with Zenzai and left contexts\n"
+        << "  -s, --socket PATH       use this hazkey-server (default: start "
+           "a private one)\n"
+        << "  -h, --help              show this help\n";
+}
+
+std::optional<Options> parseArguments(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        if (arg == "-h" || arg == "--help") {
+            return std::nullopt;
+        } else if (arg == "-f" || arg == "--format") {
+            const char* format = value();
+            if (format != nullptr && std::strcmp(format, "tsv") == 0) {
+                options.format = Format::Tsv;
+            } else if (format != nullptr &&
+                       std::strcmp(format, "jsonl") == 0) {
+                options.format = Format::Jsonl;
+            } else {
+                return std::nullopt;
+            }
+        } else if (arg == "-n" || arg == "--n-best") {
+            const char* n = value();
+            if (n == nullptr || (options.nBest = std::atoi(n)) <= 0) {
+                return std::nullopt;
+            }
+        } else if (arg == "-b" || arg == "--batch-size") {
+            const char* n = value();
+            if (n == nullptr || (options.batchSize = std::atoi(n)) <= 0) {
+                return std::nullopt;
+            }
+        } else if (arg == "-z" || arg == "--zenzai") {
+            options.useZenzai = true;
+        } else if (arg == "-s" || arg == "--socket") {
+            const char* path = value();
+            if (path == nullptr) {
+                return std::nullopt;
+            }
+            options.socketPath = path;
+        } else if (!arg.empty() && arg[0] != '-' &&
+                   options.inputPath.empty()) {
+            options.inputPath = arg;
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+// hazkey-server in a runtime directory of its own, stopped on destruction
+class PrivateServer {
+   public:
+    PrivateServer() = default;
+    PrivateServer(const PrivateServer&) = delete;
+    PrivateServer& operator=(const PrivateServer&) = delete;
+
+    ~PrivateServer() {
+        if (pid_ > 0) {
+            kill(pid_, SIGTERM);
+            // as ProcessManager does, kill it if it does not stop in time
+            for (int i = 0; i < 20; ++i) {
+                if (waitpid(pid_, nullptr, WNOHANG) == pid_) {
+                    pid_ = -1;
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            if (pid_ > 0) {
+                kill(pid_, SIGKILL);
+                waitpid(pid_, nullptr, 0);
+            }
+        }
+        if (!runtimeDir_.empty()) {
+            std::error_code error;
+            std::filesystem::remove_all(runtimeDir_, error);
+        }
+    }
+
+    // Starts the server and connects to it; returns the socket or -1.
+    int start() {
+        char dir[] = "/tmp/hazkey-convert-XXXXXX";
+        if (mkdtemp(dir) == nullptr) {
+            std::perror("mkdtemp");
+            return -1;
+        }
+        runtimeDir_ = dir;
+        pid_ = fork();
+        if (pid_ < 0) {
+            std::perror("fork");
+            return -1;
+        }
+        if (pid_ == 0) {
+            setenv("XDG_RUNTIME_DIR", dir, 1);
+            execlp("hazkey-server", "hazkey-server", nullptr);
+            std::perror("hazkey-server");
+            _exit(127);
+        }
+
+        std::string socketPath = std::string(dir) + "/hazkey-server." +
+                                 std::to_string(getuid()) + ".sock";
+        // the server loads the dictionary before it listens
+        constexpr int kRetryIntervalMs = 100;
+        constexpr int kMaxRetries = 300;
+        for (int attempt = 0; attempt < kMaxRetries; ++attempt) {
+            int fd = connectSocket(socketPath);
+            if (fd >= 0) {
+                return fd;
+            }
+            if (waitpid(pid_, nullptr, WNOHANG) == pid_) {
+                pid_ = -1;
+                std::cerr << "hazkey-server exited during startup\n";
+                return -1;
+            }
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(kRetryIntervalMs));
+        }
+        std::cerr << "hazkey-server did not start listening\n";
+        return -1;
+    }
+
+   private:
+    std::filesystem::path runtimeDir_;
+    pid_t pid_ = -1;
+};
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+// Parses the JSON string starting at line[pos] (the opening quote).
+std::optional<std::string> parseJsonString(const std::string& line,
+                                           size_t& pos) {
+    if (pos >= line.size() || line[pos] != '"') {
+        return std::nullopt;
+    }
+    std::string out;
+    for (++pos; pos < line.size(); ++pos) {
+        char c = line[pos];
+        if (c == '"') {
+            ++pos;
+            return out;
+        }
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (++pos >= line.size()) {
+            return std::nullopt;
+        }
+        switch (line[pos]) {
+            case '"':
+            case '\\':
+            case '/':
+                out += line[pos];
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                // four hex digits after line[pos]
+                auto readHex = [&](uint32_t& value) {
+                    if (pos + 4 >= line.size()) {
+                        return false;
+                    }
+                    value = 0;
+                    for (int i = 1; i <= 4; ++i) {
+                        char digit = line[pos + i];
+                        value <<= 4;
+                        if (digit >= '0' && digit <= '9') {
+                            value |= digit - '0';
+                        } else if (digit >= 'a' && digit <= 'f') {
+                            value |= digit - 'a' + 10;
+                        } else if (digit >= 'A' && digit <= 'F') {
+                            value |= digit - 'A' + 10;
+                        } else {
+                            return false;
+                        }
+                    }
+                    pos += 4;
+                    return true;
+                };
+                uint32_t codepoint;
+                if (!readHex(codepoint)) {
+                    return std::nullopt;
+                }
+                if (codepoint >= 0xDC00 && codepoint < 0xE000) {
+                    // low surrogate without a high one
+                    return std::nullopt;
+                }
+                if (codepoint >= 0xD800 && codepoint < 0xDC00) {
+                    uint32_t low;
+                    if (line.compare(pos + 1, 2, "\\u") != 0) {
+                        return std::nullopt;
+                    }
+                    pos += 2;
+                    if (!readHex(low) || low < 0xDC00 || low >= 0xE000) {
+                        return std::nullopt;
+                    }
+                    codepoint =
+                        0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, codepoint);
+                break;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+// Reads "reading" and "left_context" from a flat JSON object.
+std::optional<hazkey::commands::ConvertBatch::Item> parseJsonlItem(
+    const std::string& line) {
+    hazkey::commands::ConvertBatch::Item item;
+    bool hasReading = false;
+    size_t pos = line.find('{');
+    if (pos == std::string::npos) {
+        return std::nullopt;
+    }
+    ++pos;
+    while (pos < line.size()) {
+        pos = line.find_first_not_of(" \t,", pos);
+        if (pos == std::string::npos || line[pos] == '}') {
+            break;
+        }
+        auto key = parseJsonString(line, pos);
+        if (!key) {
+            return std::nullopt;
+        }
+        pos = line.find_first_not_of(" \t", pos);
+        if (pos == std::string::npos || line[pos] != ':') {
+            return std::nullopt;
+        }
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos) {
+            return std::nullopt;
+        }
+        auto value = parseJsonString(line, pos);
+        if (!value) {
+            return std::nullopt;
+        }
+        if (*key == "reading") {
+            item.set_reading(*value);
+            hasReading = true;
+        } else if (*key == "left_context") {
+            item.set_left_context(*value);
+        }
+    }
+    if (!hasReading) {
+        return std::nullopt;
+    }
+    return item;
+}
+
+std::optional<hazkey::commands::ConvertBatch::Item> parseTsvItem(
+    const std::string& line) {
+    hazkey::commands::ConvertBatch::Item item;
+    auto tab = line.find('\t');
+    item.set_reading(line.substr(0, tab));
+    if (tab != std::string::npos) {
+        item.set_left_context(line.substr(tab + 1));
+    }
+    if (item.reading().empty()) {
+        return std::nullopt;
+    }
+    return item;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    out += '"';
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+void writeResult(Format format,
+                 const hazkey::commands::ConvertBatch::Item& item,
+                 const hazkey::commands::ConvertBatchResult::Item& result) {
+    if (format == Format::Tsv) {
+        std::cout << item.reading();
+        for (const auto& candidate : result.candidates()) {
+            std::cout << '\t' << candidate;
+        }
+        std::cout << '\n';
+    } else {
+        std::cout << "{\"reading\":" << jsonEscape(item.reading())
+                  << ",\"candidates\":[";
+        for (int i = 0; i < result.candidates_size(); ++i) {
+            std::cout << (i == 0 ? "" : ",")
+                      << jsonEscape(result.candidates(i));
+        }
+        std::cout << "]}\n";
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto options = parseArguments(argc, argv);
+    if (!options) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::ifstream file;
+    if (!options->inputPath.empty()) {
+        file.open(options->inputPath);
+        if (!file) {
+            std::cerr << "Failed to open " << options->inputPath << "\n";
+            return 1;
+        }
+    }
+    std::istream& input = options->inputPath.empty() ? std::cin : file;
+
+    PrivateServer privateServer;
+    int fd;
+    if (options->socketPath.empty()) {
+        fd = privateServer.start();
+    } else if (options->socketPath == defaultSocketPath()) {
+        std::cerr << "Refusing to use the addon's hazkey-server; omit "
+                     "--socket to start a private one\n";
+        return 2;
+    } else {
+        fd = connectSocket(options->socketPath);
+        if (fd < 0) {
+            std::perror(
+                ("Failed to connect to " + options->socketPath).c_str());
+        }
+    }
+    if (fd < 0) {
+        return 1;
+    }
+    // never starts or reconnects to the addon's server
+    HazkeyServerConnector server(fd);
+
+    hazkey::commands::ConvertBatch batch;
+    batch.set_n_best(options->nBest);
+    batch.set_use_zenzai(options->useZenzai);
+
+    size_t converted = 0;
+    size_t skipped = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    auto flush = [&]() {
+        if (batch.items_size() == 0) {
+            return true;
+        }
+        auto result = server.convertBatch(batch);
+        if (!result || result->items_size() != batch.items_size()) {
+            std::cerr << "ConvertBatch failed after " << converted
+                      << " readings\n";
+            return false;
+        }
+        for (int i = 0; i < batch.items_size(); ++i) {
+            writeResult(options->format, batch.items(i), result->items(i));
+        }
+        converted += batch.items_size();
+        batch.clear_items();
+        return true;
+    };
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (line.empty()) {
+            continue;
+        }
+        auto item = options->format == Format::Tsv ? parseTsvItem(line)
+                                                   : parseJsonlItem(line);
+        if (!item) {
+            std::cerr << "Skipping malformed line " << lineNumber << "\n";
+            ++skipped;
+            continue;
+        }
+        *batch.add_items() = std::move(*item);
+        if (batch.items_size() >= options->batchSize && !flush()) {
+            return 1;
+        }
+    }
+    if (!flush()) {
+        return 1;
+    }
+    std::cout.flush();
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    std::cerr << "Converted " << converted << " readings in " << seconds
+              << " s (" << (seconds > 0 ? converted / seconds : 0)
+              << " readings/s)";
+    if (skipped > 0) {
+        std::cerr << ", skipped " << skipped << " malformed lines";
+    }
+    std::cerr << "\n";
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "hazkey_fake_server.h"
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "commands.pb.h"
+
+namespace {
+
+// the limit HazkeyServerConnector enforces on responses
+constexpr uint32_t kMaxFrameSize = 2 * 1024 * 1024;
+
+// 3 bytes each in UTF-8, like most candidate text
+constexpr const char* kKana[] = {"あ", "い", "う", "え", "お",
+                                 "か", "き", "く", "け", "こ"};
+
+bool readExactly(int fd, char* data, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = read(fd, data + done, len - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+bool writeExactly(int fd, const char* data, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = write(fd, data + done, len - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+}  // namespace
+
+HazkeyFakeServer::HazkeyFakeServer(Options options)
+    : options_(std::move(options)) {
+    candidates_.set_status(hazkey::SUCCESS);
+    *candidates_.mutable_candidates() =
+        makeCandidates(options_.numCandidates, options_.candidateLength);
+}
+
+hazkey::commands::CandidatesResult HazkeyFakeServer::makeCandidates(
+    int count, int length) {
+    hazkey::commands::CandidatesResult result;
+    for (int i = 0; i < count; i++) {
+        auto* candidate = result.add_candidates();
+        std::string text;
+        for (int j = 0; j < length; j++) {
+            text += kKana[(i + j) % std::size(kKana)];
+        }
+        candidate->set_text(text);
+        candidate->set_sub_hiragana(i % 2 == 0 ? "" : "のこり");
+    }
+    result.set_live_text(count > 0 ? result.candidates(0).text() : "");
+    result.set_live_text_index(count > 0 ? 0 : -1);
+    result.set_page_size(9);
+    return result;
+}
+
+hazkey::ResponseEnvelope HazkeyFakeServer::respond(
+    const hazkey::RequestEnvelope& request) {
+    hazkey::ResponseEnvelope response;
+    response.set_status(hazkey::SUCCESS);
+    switch (request.payload_case()) {
+        case hazkey::RequestEnvelope::kGetCandidates:
+            return candidates_;
+        case hazkey::RequestEnvelope::kGetComposingString:
+            response.set_text("きょうはいいてんき");
+            break;
+        case hazkey::RequestEnvelope::kGetHiraganaWithCursor:
+            response.mutable_text_with_cursor()->set_beforecursosr(
+                "きょうはいいてんき");
+            break;
+        case hazkey::RequestEnvelope::kGetCurrentInputMode:
+            response.mutable_current_input_mode_info()
+                ->set_submode_entry_point_chars("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+            break;
+        case hazkey::RequestEnvelope::PAYLOAD_NOT_SET:
+            response.set_status(hazkey::FAILED);
+            response.set_error_message("Empty request.");
+            break;
+        default:
+            // commands without a result
+            break;
+    }
+    return response;
+}
+
+bool HazkeyFakeServer::handle(int fd, const hazkey::RequestEnvelope& request) {
+    std::string out;
+    return respond(request).SerializeToString(&out) && writeFrame(fd, out);
+}
+
+uint64_t HazkeyFakeServer::serve(int fd) {
+    uint64_t answered = 0;
+    std::string frame;
+    while (readFrame(fd, frame)) {
+        hazkey::RequestEnvelope request;
+        if (!request.ParseFromString(frame) || !handle(fd, request)) {
+            break;
+        }
+        answered++;
+    }
+    return answered;
+}
+
+bool HazkeyFakeServer::readFrame(int fd, std::string& frame) {
+    uint32_t length;
+    if (!readExactly(fd, reinterpret_cast<char*>(&length), 4)) {
+        return false;
+    }
+    length = ntohl(length);
+    if (length > kMaxFrameSize) {
+        return false;
+    }
+    frame.resize(length);
+    return readExactly(fd, frame.data(), length);
+}
+
+bool HazkeyFakeServer::writeFrame(int fd, const std::string& frame) {
+    uint32_t length = htonl(frame.size());
+    return writeExactly(fd, reinterpret_cast<const char*>(&length), 4) &&
+           writeExactly(fd, frame.data(), frame.size());
+}
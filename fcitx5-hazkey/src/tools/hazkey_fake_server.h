@@ -0,0 +1,50 @@
+#ifndef HAZKEY_FAKE_SERVER_H
+#define HAZKEY_FAKE_SERVER_H
+
+#include <cstdint>
+#include <string>
+
+#include "base.pb.h"
+
+// Answers hazkey-server requests with canned responses, using the same
+// length-prefixed framing. It holds no conversion state, so its latency is
+// that of the transport alone.
+class HazkeyFakeServer {
+   public:
+    struct Options {
+        // candidates in every CandidatesResult
+        int numCandidates = 10;
+        // characters in every candidate text
+        int candidateLength = 8;
+    };
+
+    explicit HazkeyFakeServer(Options options);
+    virtual ~HazkeyFakeServer() = default;
+
+    // Serves requests from a blocking socket until the peer closes it or a
+    // frame is malformed. Returns the number of requests answered.
+    uint64_t serve(int fd);
+
+    // answers one request on fd; false ends the connection
+    virtual bool handle(int fd, const hazkey::RequestEnvelope& request);
+
+    // the response to one request
+    virtual hazkey::ResponseEnvelope respond(
+        const hazkey::RequestEnvelope& request);
+
+    // a CandidatesResult as large as the options ask for
+    static hazkey::commands::CandidatesResult makeCandidates(int count,
+                                                            int length);
+
+    // 4-byte big-endian length, then the message
+    static bool readFrame(int fd, std::string& frame);
+    static bool writeFrame(int fd, const std::string& frame);
+
+   protected:
+    Options options_;
+
+   private:
+    hazkey::ResponseEnvelope candidates_;
+};
+
+#endif  // HAZKEY_FAKE_SERVER_H
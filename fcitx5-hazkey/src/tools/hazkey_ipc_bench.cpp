@@ -0,0 +1,241 @@
+// hazkey-ipc-bench: measures HazkeyServerConnector against an in-process
+// fake server on a socketpair, so transport changes can be compared without
+// hazkey-server, its dictionary or a model.
+//
+// Output (stdout): one JSON object per line
+//   {"bench":"round_trip","case":"get_candidates","iterations":N,
+//    "mean_us":..,"p50_us":..,"p90_us":..,"p99_us":..}
+//   {"bench":"serialize","case":"candidates_100","bytes":..,
+//    "serialize_us":..,"parse_us":..}
+//   {"bench":"pipeline","case":"worker","commands":N,"total_ms":..,
+//    "commands_per_sec":..}
+
+#include <fcitx-utils/eventloop.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base.pb.h"
+#include "commands.pb.h"
+#include "hazkey_fake_server.h"
+#include "hazkey_server_connector.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int iterations = 2000;
+    int numCandidates = 10;
+    int pipelineCommands = 10000;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "Benchmark the addon's IPC layer against a fake server.\n\n"
+              << "  -n, --iterations N   round trips per command (default: "
+                 "2000)\n"
+              << "  -c, --candidates N   candidates per GetCandidates "
+                 "response (default: 10)\n"
+              << "  -p, --pipeline N     commands per pipelining run "
+                 "(default: 10000)\n"
+              << "  -h, --help           show this help\n";
+}
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        int* target = nullptr;
+        if (arg == "-n" || arg == "--iterations") {
+            target = &options.iterations;
+        } else if (arg == "-c" || arg == "--candidates") {
+            target = &options.numCandidates;
+        } else if (arg == "-p" || arg == "--pipeline") {
+            target = &options.pipelineCommands;
+        } else {
+            return false;
+        }
+        if (value == nullptr || (*target = std::atoi(value)) <= 0) {
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
+double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start)
+        .count();
+}
+
+// A fake server thread on one end of a socketpair; the connector gets the
+// other end.
+class FakeServerPair {
+   public:
+    explicit FakeServerPair(HazkeyFakeServer::Options options)
+        : server_(std::move(options)) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            std::perror("socketpair");
+            std::exit(1);
+        }
+        clientFd_ = fds[0];
+        serverFd_ = fds[1];
+        thread_ = std::thread([this]() { server_.serve(serverFd_); });
+    }
+
+    ~FakeServerPair() {
+        // the server sees the end of the stream and returns
+        close(clientFd_);
+        thread_.join();
+        close(serverFd_);
+    }
+
+    int clientFd() const { return clientFd_; }
+
+   private:
+    HazkeyFakeServer server_;
+    int clientFd_ = -1;
+    int serverFd_ = -1;
+    std::thread thread_;
+};
+
+void printRoundTrip(const std::string& name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1,
+                                static_cast<size_t>(p * samples.size()))];
+    };
+    std::printf(
+        "{\"bench\":\"round_trip\",\"case\":\"%s\",\"iterations\":%zu,"
+        "\"mean_us\":%.3f,\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f}\n",
+        name.c_str(), samples.size(), sum / samples.size(), percentile(0.5),
+        percentile(0.9), percentile(0.99));
+}
+
+void benchRoundTrips(const Options& options) {
+    FakeServerPair pair({options.numCandidates, 8});
+    HazkeyServerConnector server(pair.clientFd());
+
+    std::vector<std::pair<std::string, std::function<void()>>> cases = {
+        {"input_char", [&]() { server.inputChar("a"); }},
+        {"delete_left", [&]() { server.deleteLeft(); }},
+        {"move_cursor", [&]() { server.moveCursor(-1); }},
+        {"new_composing_text", [&]() { server.newComposingText(); }},
+        {"get_composing_text",
+         [&]() {
+             server.getComposingText(
+                 hazkey::commands::GetComposingString_CharType_HIRAGANA, "");
+         }},
+        {"get_hiragana_with_cursor",
+         [&]() { server.getComposingHiraganaWithCursor(); }},
+        {"get_candidates", [&]() { server.getCandidates(true); }},
+    };
+    for (auto& [name, call] : cases) {
+        for (int i = 0; i < std::min(options.iterations, 100); i++) {
+            call();
+        }
+        std::vector<double> samples;
+        samples.reserve(options.iterations);
+        for (int i = 0; i < options.iterations; i++) {
+            auto start = Clock::now();
+            call();
+            samples.push_back(elapsedUs(start));
+        }
+        printRoundTrip(name, samples);
+    }
+}
+
+void benchSerialization(const Options& options) {
+    for (int count : {10, 100, 1000}) {
+        hazkey::ResponseEnvelope response;
+        response.set_status(hazkey::SUCCESS);
+        *response.mutable_candidates() =
+            HazkeyFakeServer::makeCandidates(count, 8);
+
+        std::string bytes;
+        auto start = Clock::now();
+        for (int i = 0; i < options.iterations; i++) {
+            response.SerializeToString(&bytes);
+        }
+        double serializeUs = elapsedUs(start) / options.iterations;
+
+        hazkey::ResponseEnvelope parsed;
+        start = Clock::now();
+        for (int i = 0; i < options.iterations; i++) {
+            parsed.ParseFromString(bytes);
+        }
+        double parseUs = elapsedUs(start) / options.iterations;
+
+        std::printf(
+            "{\"bench\":\"serialize\",\"case\":\"candidates_%d\","
+            "\"bytes\":%zu,\"serialize_us\":%.3f,\"parse_us\":%.3f}\n",
+            count, bytes.size(), serializeUs, parseUs);
+    }
+}
+
+void printPipeline(const char* name, int commands, double totalUs) {
+    std::printf(
+        "{\"bench\":\"pipeline\",\"case\":\"%s\",\"commands\":%d,"
+        "\"total_ms\":%.3f,\"commands_per_sec\":%.1f}\n",
+        name, commands, totalUs / 1000, commands / (totalUs / 1e6));
+}
+
+void benchPipelining(const Options& options) {
+    // every command waits for its response
+    {
+        FakeServerPair pair({options.numCandidates, 8});
+        HazkeyServerConnector server(pair.clientFd());
+        auto start = Clock::now();
+        for (int i = 0; i < options.pipelineCommands; i++) {
+            server.inputChar("a");
+        }
+        printPipeline("sync", options.pipelineCommands, elapsedUs(start));
+    }
+    // commands are queued to the IPC worker; the last request waits for
+    // all of them
+    {
+        FakeServerPair pair({options.numCandidates, 8});
+        fcitx::EventLoop eventLoop;
+        HazkeyServerConnector server(pair.clientFd());
+        server.startWorker(&eventLoop);
+        auto start = Clock::now();
+        for (int i = 0; i < options.pipelineCommands; i++) {
+            server.inputChar("a");
+        }
+        server.getComposingText(
+            hazkey::commands::GetComposingString_CharType_HIRAGANA, "");
+        printPipeline("worker", options.pipelineCommands, elapsedUs(start));
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    benchRoundTrips(options);
+    benchSerialization(options);
+    benchPipelining(options);
+    return 0;
+}
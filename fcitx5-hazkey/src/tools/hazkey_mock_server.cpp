@@ -0,0 +1,306 @@
+// hazkey-mock-server: a stand-in for hazkey-server that speaks the same
+// socket protocol with canned responses, for testing the addon under slow
+// or failing servers without the dictionary or a model.
+//
+// The script (-f) has one rule per line; '#' starts a comment. COMMAND is a
+// request name as in hazkey-server's stats (input_char, get_candidates, ...)
+// or '*' for every request. Later rules for the same command win.
+//   latency COMMAND fixed MS
+//   latency COMMAND uniform MIN_MS MAX_MS
+//   latency COMMAND normal MEAN_MS STDDEV_MS
+//   latency COMMAND lognormal MEDIAN_MS SIGMA
+//   fail COMMAND PROBABILITY error|drop|oversize|garbage
+//   candidates COUNT LENGTH
+// fail actions: error answers with status FAILED, drop closes the
+// connection without answering, oversize sends a length above the client's
+// limit, garbage sends a frame that does not parse.
+
+#include <arpa/inet.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "base.pb.h"
+#include "hazkey_fake_server.h"
+#include "hazkey_tool_util.h"
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void handleStopSignal(int) { stopRequested = 1; }
+
+struct Latency {
+    enum class Kind { Fixed, Uniform, Normal, LogNormal };
+    Kind kind = Kind::Fixed;
+    double a = 0;
+    double b = 0;
+};
+
+enum class FailAction { Error, Drop, Oversize, Garbage };
+
+struct Failure {
+    double probability = 0;
+    FailAction action = FailAction::Error;
+};
+
+struct Script {
+    HazkeyFakeServer::Options candidates;
+    std::map<std::string, Latency> latencies;
+    std::map<std::string, Failure> failures;
+};
+
+std::optional<Script> loadScript(std::istream& input) {
+    Script script;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string rule;
+        if (!(words >> rule)) {
+            continue;
+        }
+        bool ok = false;
+        if (rule == "latency") {
+            std::string command, kind;
+            Latency latency;
+            words >> command >> kind >> latency.a;
+            if (kind == "fixed") {
+                latency.kind = Latency::Kind::Fixed;
+                ok = !words.fail();
+            } else if (kind == "uniform" || kind == "normal" ||
+                       kind == "lognormal") {
+                latency.kind = kind == "uniform"  ? Latency::Kind::Uniform
+                               : kind == "normal" ? Latency::Kind::Normal
+                                                  : Latency::Kind::LogNormal;
+                words >> latency.b;
+                ok = !words.fail();
+            }
+            if (ok) {
+                script.latencies[command] = latency;
+            }
+        } else if (rule == "fail") {
+            std::string command, action;
+            Failure failure;
+            words >> command >> failure.probability >> action;
+            static const std::map<std::string, FailAction> actions = {
+                {"error", FailAction::Error},
+                {"drop", FailAction::Drop},
+                {"oversize", FailAction::Oversize},
+                {"garbage", FailAction::Garbage},
+            };
+            auto found = actions.find(action);
+            ok = !words.fail() && found != actions.end();
+            if (ok) {
+                failure.action = found->second;
+                script.failures[command] = failure;
+            }
+        } else if (rule == "candidates") {
+            words >> script.candidates.numCandidates >>
+                script.candidates.candidateLength;
+            ok = !words.fail();
+        }
+        if (!ok) {
+            std::cerr << "Invalid rule on line " << lineNumber << ": " << line
+                      << "\n";
+            return std::nullopt;
+        }
+    }
+    return script;
+}
+
+class MockServer : public HazkeyFakeServer {
+   public:
+    MockServer(Script script, uint64_t seed)
+        : HazkeyFakeServer(script.candidates),
+          script_(std::move(script)),
+          random_(seed) {}
+
+    bool handle(int fd, const hazkey::RequestEnvelope& request) override {
+        std::string name = requestName(request);
+        if (auto latency = find(script_.latencies, name)) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double, std::milli>(sample(*latency)));
+        }
+        auto failure = find(script_.failures, name);
+        if (failure == nullptr ||
+            std::uniform_real_distribution<double>(0, 1)(random_) >=
+                failure->probability) {
+            return HazkeyFakeServer::handle(fd, request);
+        }
+
+        failures_++;
+        switch (failure->action) {
+            case FailAction::Error: {
+                hazkey::ResponseEnvelope response;
+                response.set_status(hazkey::FAILED);
+                response.set_error_message("Injected failure.");
+                std::string out;
+                return response.SerializeToString(&out) &&
+                       writeFrame(fd, out);
+            }
+            case FailAction::Drop:
+                return false;
+            case FailAction::Oversize: {
+                uint32_t length = htonl(64 * 1024 * 1024);
+                write(fd, &length, 4);
+                return false;
+            }
+            case FailAction::Garbage:
+                // a length-delimited field that runs past the end
+                return writeFrame(fd, std::string("\x0a\x7f\x01", 3));
+        }
+        return false;
+    }
+
+    uint64_t failures() const { return failures_; }
+
+   private:
+    template <typename T>
+    const T* find(const std::map<std::string, T>& rules,
+                  const std::string& name) const {
+        auto found = rules.find(name);
+        if (found == rules.end()) {
+            found = rules.find("*");
+        }
+        return found == rules.end() ? nullptr : &found->second;
+    }
+
+    double sample(const Latency& latency) {
+        double ms = latency.a;
+        switch (latency.kind) {
+            case Latency::Kind::Fixed:
+                break;
+            case Latency::Kind::Uniform:
+                ms = std::uniform_real_distribution<double>(latency.a,
+                                                            latency.b)(random_);
+                break;
+            case Latency::Kind::Normal:
+                ms = std::normal_distribution<double>(latency.a,
+                                                      latency.b)(random_);
+                break;
+            case Latency::Kind::LogNormal:
+                ms = std::lognormal_distribution<double>(std::log(latency.a),
+                                                         latency.b)(random_);
+                break;
+        }
+        return std::max(ms, 0.0);
+    }
+
+    Script script_;
+    std::mt19937_64 random_;
+    uint64_t failures_ = 0;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options]\n"
+              << "Serve canned hazkey-server responses on the addon's "
+                 "socket.\n\n"
+              << "  -s, --socket PATH  listen here (default: the path the "
+                 "addon connects to)\n"
+              << "  -f, --script FILE  latency and failure rules\n"
+              << "      --seed N       random seed (default: 1)\n"
+              << "  -h, --help         show this help\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string socketPath;
+    std::string scriptPath;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if ((arg == "-s" || arg == "--socket") && value != nullptr) {
+            socketPath = value;
+        } else if ((arg == "-f" || arg == "--script") && value != nullptr) {
+            scriptPath = value;
+        } else if (arg == "--seed" && value != nullptr) {
+            seed = std::strtoull(value, nullptr, 10);
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    Script script;
+    if (!scriptPath.empty()) {
+        std::ifstream file(scriptPath);
+        if (!file) {
+            std::cerr << "Failed to open " << scriptPath << "\n";
+            return 1;
+        }
+        auto loaded = loadScript(file);
+        if (!loaded) {
+            return 1;
+        }
+        script = std::move(*loaded);
+    }
+    if (socketPath.empty()) {
+        socketPath = defaultSocketPath();
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(socketPath.c_str());
+    if (listener < 0 ||
+        bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listener, 4) != 0) {
+        std::perror("Failed to listen");
+        return 1;
+    }
+
+    // no SA_RESTART, so accept() returns on a signal
+    struct sigaction action {};
+    action.sa_handler = handleStopSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "Listening on " << socketPath << "\n";
+    MockServer server(std::move(script), seed);
+    uint64_t connections = 0;
+    uint64_t requests = 0;
+    while (!stopRequested) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        connections++;
+        uint64_t answered = server.serve(client);
+        requests += answered;
+        close(client);
+        std::cerr << "Connection " << connections << " closed after "
+                  << answered << " requests\n";
+    }
+
+    close(listener);
+    unlink(socketPath.c_str());
+    std::cerr << connections << " connections, " << requests
+              << " requests, " << server.failures() << " injected failures\n";
+    return 0;
+}
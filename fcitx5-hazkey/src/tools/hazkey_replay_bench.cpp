@@ -0,0 +1,407 @@
+// hazkey-replay-bench: types a corpus through HazkeyEngine with fcitx5's test
+// frontend and reports, for each key, the time from the press until the input
+// panel showed its result. Input queued for a later flush and suggestions
+// that arrive asynchronously count towards the key. The addon talks to
+// whatever hazkey-server it finds on its socket, so start hazkey-mock-server
+// first to replay against the mock; otherwise hazkey-server is started as
+// usual.
+//
+// The corpus has one key per line; '#' starts a comment. DELAY_MS is the time
+// since the previous key (default: -i), KEY is a fcitx5 key name such as a,
+// space, Return, BackSpace, Tab, F7, Shift_L or Control+a.
+//   [DELAY_MS] KEY
+//   type INTERVAL_MS TEXT     one key per character of TEXT
+//
+// Output (stdout): one JSON object per line
+//   {"bench":"replay","case":"all","keys":N,"mean_us":..,"p50_us":..,
+//    "p90_us":..,"p99_us":..,"max_us":..}
+//   ... the same for each kind of key ("char", "space", "Return", ...)
+//   {"bench":"replay","case":"summary","keys":N,"requests":..,
+//    "requests_per_key":..,"unsettled":..,"wall_ms":..,
+//    "committed":".."}
+
+#include <fcitx-utils/event.h>
+#include <fcitx-utils/eventdispatcher.h>
+#include <fcitx-utils/key.h>
+#include <fcitx-utils/log.h>
+#include <fcitx-utils/testing.h>
+#include <fcitx-utils/utf8.h>
+#include <fcitx/addonmanager.h>
+#include <fcitx/event.h>
+#include <fcitx/inputcontextmanager.h>
+#include <fcitx/inputmethodgroup.h>
+#include <fcitx/inputmethodmanager.h>
+#include <fcitx/instance.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hazkey_engine.h"
+#include "testfrontend_public.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string corpusPath;
+    int intervalMs = 120;
+    // divides every delay; ignored with fast
+    double speed = 1.0;
+    bool fast = false;
+    // time for asynchronous work to finish after the last key
+    int settleMs = 500;
+};
+
+struct Step {
+    uint64_t delayUs;
+    fcitx::Key key;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options] -f CORPUS\n"
+              << "Replay typed keys through the addon and measure each key.\n\n"
+              << "  -f, --corpus FILE    keys to replay\n"
+              << "  -i, --interval MS    delay for keys without one "
+                 "(default: 120)\n"
+              << "      --speed X        replay X times faster (default: 1)\n"
+              << "      --fast           do not wait between keys\n"
+              << "      --settle MS      wait after the last key (default: "
+                 "500)\n"
+              << "  -h, --help           show this help\n";
+}
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--fast") {
+            options.fast = true;
+            continue;
+        }
+        if (value == nullptr) {
+            return false;
+        }
+        if (arg == "-f" || arg == "--corpus") {
+            options.corpusPath = value;
+        } else if (arg == "-i" || arg == "--interval") {
+            options.intervalMs = std::atoi(value);
+        } else if (arg == "--speed") {
+            options.speed = std::atof(value);
+        } else if (arg == "--settle") {
+            options.settleMs = std::atoi(value);
+        } else {
+            return false;
+        }
+        ++i;
+    }
+    return !options.corpusPath.empty() && options.intervalMs >= 0 &&
+           options.speed > 0 && options.settleMs >= 0;
+}
+
+bool isNumber(const std::string& word) {
+    return !word.empty() &&
+           std::all_of(word.begin(), word.end(),
+                       [](char c) { return c >= '0' && c <= '9'; });
+}
+
+std::optional<std::vector<Step>> loadCorpus(std::istream& input,
+                                            const Options& options) {
+    std::vector<Step> steps;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        if (auto comment = line.find('#'); comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream words(line);
+        std::string first;
+        if (!(words >> first)) {
+            continue;
+        }
+        bool ok = true;
+        if (first == "type") {
+            std::string interval, text;
+            words >> interval;
+            std::getline(words >> std::ws, text);
+            ok = isNumber(interval) && fcitx::utf8::validate(text);
+            if (ok) {
+                uint64_t delayUs = std::stoull(interval) * 1000;
+                for (uint32_t c : fcitx::utf8::MakeUTF8CharRange(text)) {
+                    auto sym = fcitx::Key::keySymFromUnicode(c);
+                    steps.push_back({delayUs, fcitx::Key(sym)});
+                }
+            }
+        } else {
+            uint64_t delayUs = options.intervalMs * 1000ULL;
+            std::string name = first;
+            if (isNumber(first)) {
+                delayUs = std::stoull(first) * 1000;
+                name.clear();
+                words >> name;
+            }
+            fcitx::Key key(name);
+            ok = key.isValid();
+            if (ok) {
+                steps.push_back({delayUs, key});
+            }
+        }
+        if (!ok) {
+            std::cerr << "Invalid corpus line " << lineNumber << ": " << line
+                      << "\n";
+            return std::nullopt;
+        }
+    }
+    return steps;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            escaped += buf;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void printLatencies(const std::string& name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1,
+                                static_cast<size_t>(p * samples.size()))];
+    };
+    std::printf(
+        "{\"bench\":\"replay\",\"case\":\"%s\",\"keys\":%zu,\"mean_us\":%.3f,"
+        "\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f}\n",
+        jsonEscape(name).c_str(), samples.size(), sum / samples.size(),
+        percentile(0.5), percentile(0.9), percentile(0.99), samples.back());
+}
+
+// Sends the steps from timer callbacks, so the event loop keeps running
+// between keys and asynchronous results arrive as they would while typing.
+class Replay {
+   public:
+    Replay(fcitx::Instance* instance, std::vector<Step> steps,
+           const Options& options)
+        : instance_(instance), steps_(std::move(steps)), options_(options) {}
+
+    void start() {
+        auto& addons = instance_->addonManager();
+        engine_ =
+            static_cast<fcitx::HazkeyEngine*>(addons.addon("hazkey", true));
+        frontend_ = addons.addon("testfrontend");
+        if (engine_ == nullptr || frontend_ == nullptr) {
+            std::cerr << "Failed to load the hazkey or testfrontend addon\n";
+            instance_->exit();
+            return;
+        }
+
+        auto& inputMethods = instance_->inputMethodManager();
+        auto group = inputMethods.currentGroup();
+        group.inputMethodList().clear();
+        group.inputMethodList().push_back(
+            fcitx::InputMethodGroupItem("keyboard-us"));
+        group.inputMethodList().push_back(
+            fcitx::InputMethodGroupItem("hazkey"));
+        group.setDefaultInputMethod("");
+        inputMethods.setGroup(group);
+
+        uuid_ = frontend_->call<fcitx::ITestFrontend::createInputContext>(
+            "hazkey-replay-bench");
+        auto* ic = instance_->inputContextManager().findByUUID(uuid_);
+        ic->focusIn();
+        instance_->setCurrentInputMethod(ic, "hazkey", true);
+
+        commitWatcher_ = instance_->watchEvent(
+            fcitx::EventType::InputContextCommitString,
+            fcitx::EventWatcherPhase::PreInputMethod,
+            [this](fcitx::Event& event) {
+                committed_ +=
+                    static_cast<fcitx::CommitStringEvent&>(event).text();
+            });
+
+        // the key's result is shown once the UI update finds no work left
+        updateWatcher_ = instance_->watchEvent(
+            fcitx::EventType::InputContextUpdateUI,
+            fcitx::EventWatcherPhase::Default,
+            [this](fcitx::Event&) { settleKeys(); });
+
+        requestsAtStart_ = engine_->server().requestsSent();
+        startedAt_ = Clock::now();
+        nextUs_ = fcitx::now(CLOCK_MONOTONIC);
+        timer_ = instance_->eventLoop().addTimeEvent(
+            CLOCK_MONOTONIC, nextUs_ + delayOf(0), 0,
+            [this](fcitx::EventSourceTime* source, uint64_t) {
+                return onTimer(source);
+            });
+        nextUs_ += delayOf(0);
+    }
+
+    bool succeeded() const { return finished_; }
+
+   private:
+    uint64_t delayOf(size_t index) const {
+        if (index >= steps_.size()) {
+            return options_.settleMs * 1000ULL;
+        }
+        if (options_.fast) {
+            return 0;
+        }
+        return static_cast<uint64_t>(steps_[index].delayUs / options_.speed);
+    }
+
+    bool onTimer(fcitx::EventSourceTime* source) {
+        if (next_ == steps_.size()) {
+            finish();
+            return true;
+        }
+
+        const auto& key = steps_[next_].key;
+        unsettled_.push_back(
+            {key.isSimple() ? "char" : key.toString(), Clock::now()});
+        frontend_->call<fcitx::ITestFrontend::sendKeyEvent>(uuid_, key, false);
+        // a key handled without deferred work has updated the panel by now
+        settleKeys();
+        frontend_->call<fcitx::ITestFrontend::sendKeyEvent>(uuid_, key, true);
+        next_++;
+
+        // keep to the recorded schedule unless handling fell behind it
+        uint64_t now = fcitx::now(CLOCK_MONOTONIC);
+        nextUs_ = std::max(nextUs_ + delayOf(next_), now);
+        source->setTime(nextUs_);
+        source->setOneShot();
+        return true;
+    }
+
+    // Records the keys waiting for their result once the addon has none
+    // left to show; with coalesced input, one update settles several keys.
+    void settleKeys() {
+        if (unsettled_.empty()) {
+            return;
+        }
+        auto* ic = instance_->inputContextManager().findByUUID(uuid_);
+        if (ic == nullptr || ic->propertyFor(engine_->factory())
+                                 ->hasPendingWork()) {
+            return;
+        }
+        auto end = Clock::now();
+        for (const auto& [kind, pressedAt] : unsettled_) {
+            double us =
+                std::chrono::duration<double, std::micro>(end - pressedAt)
+                    .count();
+            all_.push_back(us);
+            byKind_[kind].push_back(us);
+        }
+        unsettled_.clear();
+    }
+
+    void finish() {
+        double wallMs = std::chrono::duration<double, std::milli>(
+                            Clock::now() - startedAt_)
+                            .count();
+        uint64_t requests = engine_->server().requestsSent() - requestsAtStart_;
+        if (!all_.empty()) {
+            printLatencies("all", all_);
+        }
+        for (auto& [kind, samples] : byKind_) {
+            printLatencies(kind, samples);
+        }
+        std::printf(
+            "{\"bench\":\"replay\",\"case\":\"summary\",\"keys\":%zu,"
+            "\"requests\":%llu,\"requests_per_key\":%.3f,\"unsettled\":%zu,"
+            "\"wall_ms\":%.3f,\"committed\":\"%s\"}\n",
+            steps_.size(), static_cast<unsigned long long>(requests),
+            steps_.empty() ? 0.0
+                           : static_cast<double>(requests) / steps_.size(),
+            unsettled_.size(), wallMs, jsonEscape(committed_).c_str());
+        std::fflush(stdout);
+        finished_ = true;
+        instance_->exit();
+    }
+
+    fcitx::Instance* instance_;
+    std::vector<Step> steps_;
+    Options options_;
+
+    fcitx::HazkeyEngine* engine_ = nullptr;
+    fcitx::AddonInstance* frontend_ = nullptr;
+    fcitx::ICUUID uuid_;
+    std::unique_ptr<fcitx::HandlerTableEntry<fcitx::EventHandler>>
+        commitWatcher_;
+    std::unique_ptr<fcitx::HandlerTableEntry<fcitx::EventHandler>>
+        updateWatcher_;
+    std::unique_ptr<fcitx::EventSourceTime> timer_;
+
+    size_t next_ = 0;
+    uint64_t nextUs_ = 0;
+    uint64_t requestsAtStart_ = 0;
+    Clock::time_point startedAt_;
+    // pressed keys whose result the input panel does not show yet
+    std::vector<std::pair<std::string, Clock::time_point>> unsettled_;
+    std::vector<double> all_;
+    std::map<std::string, std::vector<double>> byKind_;
+    std::string committed_;
+    bool finished_ = false;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    std::ifstream corpus(options.corpusPath);
+    if (!corpus) {
+        std::cerr << "Failed to open " << options.corpusPath << "\n";
+        return 1;
+    }
+    auto steps = loadCorpus(corpus, options);
+    if (!steps) {
+        return 1;
+    }
+
+    // the addon and its .conf files from the build tree, the test addons
+    // from the fcitx5 installation
+    fcitx::setupTestingEnvironment(HAZKEY_ADDON_DIR, {HAZKEY_ADDON_DIR},
+                                   {HAZKEY_REPLAY_DATA_DIR});
+    char arg0[] = "hazkey-replay-bench";
+    char arg1[] = "--disable=all";
+    char arg2[] = "--enable=testim,testfrontend,testui,hazkey";
+    char* instanceArgv[] = {arg0, arg1, arg2};
+    fcitx::Instance instance(FCITX_ARRAY_SIZE(instanceArgv), instanceArgv);
+    instance.addonManager().registerDefaultLoader(nullptr);
+
+    Replay replay(&instance, std::move(*steps), options);
+    fcitx::EventDispatcher dispatcher;
+    dispatcher.attach(&instance.eventLoop());
+    dispatcher.schedule([&replay]() { replay.start(); });
+    instance.exec();
+    return replay.succeeded() ? 0 : 1;
+}
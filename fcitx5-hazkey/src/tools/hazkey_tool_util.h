@@ -0,0 +1,82 @@
+#ifndef HAZKEY_TOOL_UTIL_H
+#define HAZKEY_TOOL_UTIL_H
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "base.pb.h"
+
+// Helpers shared by the tools that stand in for the addon or the server.
+
+// same as HazkeyServerConnector::getSocketPath
+inline std::string defaultSocketPath() {
+    const char* xdg_runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    std::string sockname =
+        "hazkey-server." + std::to_string(getuid()) + ".sock";
+    if (xdg_runtime_dir && xdg_runtime_dir[0] != '\0') {
+        return std::string(xdg_runtime_dir) + "/" + sockname;
+    }
+    return "/tmp/" + sockname;
+}
+
+// a blocking connection, or -1
+inline int connectSocket(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd >= 0 &&
+        connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        return fd;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return -1;
+}
+
+// the names hazkey-server's stats use
+inline std::string requestName(const hazkey::RequestEnvelope& request) {
+    using Envelope = hazkey::RequestEnvelope;
+    switch (request.payload_case()) {
+        case Envelope::kNewComposingText:
+            return "new_composing_text";
+        case Envelope::kSetContext:
+            return "set_context";
+        case Envelope::kInputChar:
+            return "input_char";
+        case Envelope::kModifierEvent:
+            return "modifier_event";
+        case Envelope::kMoveCursor:
+            return "move_cursor";
+        case Envelope::kPrefixComplete:
+            return "prefix_complete";
+        case Envelope::kDeleteLeft:
+            return "delete_left";
+        case Envelope::kDeleteRight:
+            return "delete_right";
+        case Envelope::kGetComposingString:
+            return "get_composing_string";
+        case Envelope::kGetHiraganaWithCursor:
+            return "get_hiragana_with_cursor";
+        case Envelope::kGetCandidates:
+            return "get_candidates";
+        case Envelope::kGetCurrentInputMode:
+            return "get_current_input_mode";
+        case Envelope::kSaveLearningData:
+            return "save_learning_data";
+        case Envelope::kConvertBatch:
+            return "convert_batch";
+        case Envelope::kGetCandidatePage:
+            return "get_candidate_page";
+        default:
+            return "other";
+    }
+}
+
+#endif  // HAZKEY_TOOL_UTIL_H
@@ -0,0 +1,280 @@
+// hazkey-traffic-replay: sends the requests of a log that hazkey-server wrote
+// with HAZKEY_RECORD to a running server, at the recorded pace or as fast as
+// it answers, and reports the latency of each kind of request. Like the
+// addon, it waits for each response before sending the next request.
+//
+// The server serves one client at a time, so replaying against the addon's
+// socket would disconnect the user's input method; --socket is required and
+// must name a server started for the replay in its own runtime directory:
+//   XDG_RUNTIME_DIR=/tmp/replay hazkey-server &
+//   hazkey-traffic-replay -s /tmp/replay/hazkey-server.$UID.sock LOG
+// Requests that persist or change the user's data (prefix_complete, which
+// updates learning, save_learning_data, set_config, activate_profile,
+// clear_all_history and reload_zenzai_model) are skipped and counted unless
+// --allow-writes is given.
+//
+// Output (stdout): one JSON object per line
+//   {"bench":"traffic_replay","case":"all","requests":N,"mean_us":..,
+//    "p50_us":..,"p90_us":..,"p99_us":..,"max_us":..}
+//   ... the same for each kind of request ("input_char", ...)
+//   {"bench":"traffic_replay","case":"summary","requests":N,"failed":..,
+//    "disconnects":..,"skipped":..,"wall_ms":..,"requests_per_sec":..}
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base.pb.h"
+#include "hazkey_fake_server.h"
+#include "hazkey_tool_util.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// written by hazkey-server's TrafficRecorder
+constexpr char kMagic[] = {'H', 'Z', 'K', 'R', 'E', 'C', 0, 1};
+
+struct Options {
+    std::string logPath;
+    std::string socketPath;
+    // divides every delay; ignored with fast
+    double speed = 1.0;
+    bool fast = false;
+    bool allowWrites = false;
+};
+
+struct Record {
+    uint64_t delayUs;
+    std::string frame;
+};
+
+void printUsage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [options] LOG\n"
+              << "Replay recorded requests against a running hazkey-server."
+                 "\n\n"
+              << "  -s, --socket PATH   connect here (required; not the "
+                 "path the addon connects to)\n"
+              << "      --speed X       replay X times faster (default: 1)\n"
+              << "      --fast          send each request as soon as the "
+                 "last is answered\n"
+              << "      --allow-writes  also send requests that change "
+                 "learning data or config\n"
+              << "  -h, --help          show this help\n";
+}
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--fast") {
+            options.fast = true;
+        } else if (arg == "--allow-writes") {
+            options.allowWrites = true;
+        } else if ((arg == "-s" || arg == "--socket") && value != nullptr) {
+            options.socketPath = value;
+            ++i;
+        } else if (arg == "--speed" && value != nullptr) {
+            options.speed = std::atof(value);
+            ++i;
+        } else if (arg[0] != '-' && options.logPath.empty()) {
+            options.logPath = arg;
+        } else {
+            return false;
+        }
+    }
+    return !options.logPath.empty() && !options.socketPath.empty() &&
+           options.speed > 0;
+}
+
+// requests whose effect outlives the replay
+bool isWrite(const hazkey::RequestEnvelope& request) {
+    using Envelope = hazkey::RequestEnvelope;
+    switch (request.payload_case()) {
+        case Envelope::kPrefixComplete:
+        case Envelope::kSaveLearningData:
+        case Envelope::kSetConfig:
+        case Envelope::kActivateProfile:
+        case Envelope::kClearAllHistory:
+        case Envelope::kReloadZenzaiModel:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool readVarint(const std::string& data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<std::vector<Record>> loadLog(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open " << path << "\n";
+        return std::nullopt;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+    if (data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+        std::cerr << path << " is not a hazkey-server request log\n";
+        return std::nullopt;
+    }
+
+    std::vector<Record> records;
+    size_t pos = sizeof(kMagic);
+    while (pos < data.size()) {
+        uint64_t delayUs, length;
+        if (!readVarint(data, pos, delayUs) || !readVarint(data, pos, length) ||
+            length > data.size() - pos) {
+            // the server was killed while writing the last request
+            std::cerr << "Ignoring a truncated request at the end of the log\n";
+            break;
+        }
+        records.push_back({delayUs, data.substr(pos, length)});
+        pos += length;
+    }
+    return records;
+}
+
+void printLatencies(const std::string& name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1,
+                                static_cast<size_t>(p * samples.size()))];
+    };
+    std::printf(
+        "{\"bench\":\"traffic_replay\",\"case\":\"%s\",\"requests\":%zu,"
+        "\"mean_us\":%.3f,\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f,"
+        "\"max_us\":%.3f}\n",
+        name.c_str(), samples.size(), sum / samples.size(), percentile(0.5),
+        percentile(0.9), percentile(0.99), samples.back());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    auto records = loadLog(options.logPath);
+    if (!records) {
+        return 1;
+    }
+    if (options.socketPath == defaultSocketPath()) {
+        std::cerr << "Refusing to replay against the addon's socket; start "
+                     "a separate hazkey-server with its own XDG_RUNTIME_DIR\n";
+        return 2;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    int fd = connectSocket(options.socketPath);
+    if (fd < 0) {
+        std::perror(("Failed to connect to " + options.socketPath).c_str());
+        return 1;
+    }
+
+    std::vector<double> all;
+    std::map<std::string, std::vector<double>> byKind;
+    uint64_t failed = 0;
+    uint64_t disconnects = 0;
+    uint64_t skipped = 0;
+    auto start = Clock::now();
+    auto due = start;
+    for (const auto& record : *records) {
+        if (!options.fast) {
+            due += std::chrono::microseconds(
+                static_cast<uint64_t>(record.delayUs / options.speed));
+            std::this_thread::sleep_until(due);
+        }
+        hazkey::RequestEnvelope request;
+        if (!request.ParseFromString(record.frame)) {
+            // cannot tell what it would change
+            skipped++;
+            continue;
+        }
+        if (!options.allowWrites && isWrite(request)) {
+            skipped++;
+            continue;
+        }
+        if (fd < 0) {
+            // give whoever restarts the server time to do so
+            for (int attempt = 0; attempt < 20 && fd < 0; attempt++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                fd = connectSocket(options.socketPath);
+            }
+            if (fd < 0) {
+                std::cerr << "Server did not come back, stopping\n";
+                break;
+            }
+        }
+
+        auto begin = Clock::now();
+        std::string responseFrame;
+        if (!HazkeyFakeServer::writeFrame(fd, record.frame) ||
+            !HazkeyFakeServer::readFrame(fd, responseFrame)) {
+            disconnects++;
+            close(fd);
+            fd = -1;
+            continue;
+        }
+        double us =
+            std::chrono::duration<double, std::micro>(Clock::now() - begin)
+                .count();
+
+        hazkey::ResponseEnvelope response;
+        if (!response.ParseFromString(responseFrame) ||
+            response.status() != hazkey::SUCCESS) {
+            failed++;
+        }
+        all.push_back(us);
+        byKind[requestName(request)].push_back(us);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    double wallMs =
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count();
+    if (!all.empty()) {
+        printLatencies("all", all);
+    }
+    for (auto& [kind, samples] : byKind) {
+        printLatencies(kind, samples);
+    }
+    std::printf(
+        "{\"bench\":\"traffic_replay\",\"case\":\"summary\",\"requests\":%zu,"
+        "\"failed\":%llu,\"disconnects\":%llu,\"skipped\":%llu,"
+        "\"wall_ms\":%.3f,\"requests_per_sec\":%.1f}\n",
+        all.size(), static_cast<unsigned long long>(failed),
+        static_cast<unsigned long long>(disconnects),
+        static_cast<unsigned long long>(skipped), wallMs,
+        all.size() / (wallMs / 1000));
+    return 0;
+}
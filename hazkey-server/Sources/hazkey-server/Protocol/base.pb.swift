@@ -169,6 +169,22 @@ struct Hazkey_RequestEnvelope: Sendable {
     set {payload = .saveLearningData(newValue)}
   }
 
+  var convertBatch: Hazkey_Commands_ConvertBatch {
+    get {
+      if case .convertBatch(let v)? = payload {return v}
+      return Hazkey_Commands_ConvertBatch()
+    }
+    set {payload = .convertBatch(newValue)}
+  }
+
+  var getCandidatePage: Hazkey_Commands_GetCandidatePage {
+    get {
+      if case .getCandidatePage(let v)? = payload {return v}
+      return Hazkey_Commands_GetCandidatePage()
+    }
+    set {payload = .getCandidatePage(newValue)}
+  }
+
   var getConfig: Hazkey_Config_GetConfig {
     get {
       if case .getConfig(let v)? = payload {return v}
@@ -209,6 +225,41 @@ struct Hazkey_RequestEnvelope: Sendable {
     set {payload = .reloadZenzaiModel(newValue)}
   }
 
+  var activateProfile: Hazkey_Config_ActivateProfile {
+    get {
+      if case .activateProfile(let v)? = payload {return v}
+      return Hazkey_Config_ActivateProfile()
+    }
+    set {payload = .activateProfile(newValue)}
+  }
+
+  var getStats: Hazkey_Stats_GetStats {
+    get {
+      if case .getStats(let v)? = payload {return v}
+      return Hazkey_Stats_GetStats()
+    }
+    set {payload = .getStats(newValue)}
+  }
+
+  var flushTrace: Hazkey_Stats_FlushTrace {
+    get {
+      if case .flushTrace(let v)? = payload {return v}
+      return Hazkey_Stats_FlushTrace()
+    }
+    set {payload = .flushTrace(newValue)}
+  }
+
+  var traceID: UInt64 = 0
+
+  var inputModeState: Hazkey_Commands_InputModeState {
+    get {return _inputModeState ?? Hazkey_Commands_InputModeState()}
+    set {_inputModeState = newValue}
+  }
+  /// Returns true if `inputModeState` has been explicitly set.
+  var hasInputModeState: Bool {return self._inputModeState != nil}
+  /// Clears the value of `inputModeState`. Subsequent reads from it will return its default value.
+  mutating func clearInputModeState() {self._inputModeState = nil}
+
   var unknownFields = SwiftProtobuf.UnknownStorage()
 
   enum OneOf_Payload: Equatable, Sendable {
@@ -225,15 +276,22 @@ struct Hazkey_RequestEnvelope: Sendable {
     case getCandidates(Hazkey_Commands_GetCandidates)
     case getCurrentInputMode(Hazkey_Commands_GetCurrentInputModeInfo)
     case saveLearningData(Hazkey_Commands_SaveLearningData)
+    case convertBatch(Hazkey_Commands_ConvertBatch)
+    case getCandidatePage(Hazkey_Commands_GetCandidatePage)
     case getConfig(Hazkey_Config_GetConfig)
     case setConfig(Hazkey_Config_SetConfig)
     case getDefaultProfile(Hazkey_Config_GetDefaultProfile)
     case clearAllHistory_p(Hazkey_Config_ClearAllHistory)
     case reloadZenzaiModel(Hazkey_Config_ReloadZenzaiModel)
+    case activateProfile(Hazkey_Config_ActivateProfile)
+    case getStats(Hazkey_Stats_GetStats)
+    case flushTrace(Hazkey_Stats_FlushTrace)
 
   }
 
   init() {}
+
+  fileprivate var _inputModeState: Hazkey_Commands_InputModeState? = nil
 }
 
 struct Hazkey_ResponseEnvelope: Sendable {
@@ -279,6 +337,14 @@ struct Hazkey_ResponseEnvelope: Sendable {
     set {payload = .currentInputModeInfo(newValue)}
   }
 
+  var convertBatchResult: Hazkey_Commands_ConvertBatchResult {
+    get {
+      if case .convertBatchResult(let v)? = payload {return v}
+      return Hazkey_Commands_ConvertBatchResult()
+    }
+    set {payload = .convertBatchResult(newValue)}
+  }
+
   var currentConfig: Hazkey_Config_CurrentConfig {
     get {
       if case .currentConfig(let v)? = payload {return v}
@@ -287,6 +353,14 @@ struct Hazkey_ResponseEnvelope: Sendable {
     set {payload = .currentConfig(newValue)}
   }
 
+  var serverStats: Hazkey_Stats_ServerStats {
+    get {
+      if case .serverStats(let v)? = payload {return v}
+      return Hazkey_Stats_ServerStats()
+    }
+    set {payload = .serverStats(newValue)}
+  }
+
   var unknownFields = SwiftProtobuf.UnknownStorage()
 
   enum OneOf_Payload: Equatable, Sendable {
@@ -294,7 +368,9 @@ struct Hazkey_ResponseEnvelope: Sendable {
     case candidates(Hazkey_Commands_CandidatesResult)
     case textWithCursor(Hazkey_Commands_TextWithCursor)
     case currentInputModeInfo(Hazkey_Commands_CurrentInputModeInfo)
+    case convertBatchResult(Hazkey_Commands_ConvertBatchResult)
     case currentConfig(Hazkey_Config_CurrentConfig)
+    case serverStats(Hazkey_Stats_ServerStats)
 
   }
 
@@ -329,11 +405,18 @@ extension Hazkey_RequestEnvelope: SwiftProtobuf.Message, SwiftProtobuf._MessageI
     11: .standard(proto: "get_candidates"),
     12: .standard(proto: "get_current_input_mode"),
     13: .standard(proto: "save_learning_data"),
+    14: .standard(proto: "convert_batch"),
+    15: .standard(proto: "get_candidate_page"),
     100: .standard(proto: "get_config"),
     101: .standard(proto: "set_config"),
     102: .standard(proto: "get_default_profile"),
     103: .standard(proto: "clear_all_history"),
     104: .standard(proto: "reload_zenzai_model"),
+    105: .standard(proto: "activate_profile"),
+    200: .standard(proto: "get_stats"),
+    201: .standard(proto: "flush_trace"),
+    300: .standard(proto: "trace_id"),
+    301: .standard(proto: "input_mode_state"),
   ]
 
   mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
@@ -511,6 +594,32 @@ extension Hazkey_RequestEnvelope: SwiftProtobuf.Message, SwiftProtobuf._MessageI
           self.payload = .saveLearningData(v)
         }
       }()
+      case 14: try {
+        var v: Hazkey_Commands_ConvertBatch?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .convertBatch(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .convertBatch(v)
+        }
+      }()
+      case 15: try {
+        var v: Hazkey_Commands_GetCandidatePage?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .getCandidatePage(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .getCandidatePage(v)
+        }
+      }()
       case 100: try {
         var v: Hazkey_Config_GetConfig?
         var hadOneofValue = false
@@ -576,6 +685,47 @@ extension Hazkey_RequestEnvelope: SwiftProtobuf.Message, SwiftProtobuf._MessageI
           self.payload = .reloadZenzaiModel(v)
         }
       }()
+      case 105: try {
+        var v: Hazkey_Config_ActivateProfile?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .activateProfile(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .activateProfile(v)
+        }
+      }()
+      case 200: try {
+        var v: Hazkey_Stats_GetStats?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .getStats(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .getStats(v)
+        }
+      }()
+      case 201: try {
+        var v: Hazkey_Stats_FlushTrace?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .flushTrace(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .flushTrace(v)
+        }
+      }()
+      case 300: try { try decoder.decodeSingularUInt64Field(value: &self.traceID) }()
+      case 301: try { try decoder.decodeSingularMessageField(value: &self._inputModeState) }()
       default: break
       }
     }
@@ -639,6 +789,14 @@ extension Hazkey_RequestEnvelope: SwiftProtobuf.Message, SwiftProtobuf._MessageI
       guard case .saveLearningData(let v)? = self.payload else { preconditionFailure() }
       try visitor.visitSingularMessageField(value: v, fieldNumber: 13)
     }()
+    case .convertBatch?: try {
+      guard case .convertBatch(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 14)
+    }()
+    case .getCandidatePage?: try {
+      guard case .getCandidatePage(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 15)
+    }()
     case .getConfig?: try {
       guard case .getConfig(let v)? = self.payload else { preconditionFailure() }
       try visitor.visitSingularMessageField(value: v, fieldNumber: 100)
@@ -659,13 +817,33 @@ extension Hazkey_RequestEnvelope: SwiftProtobuf.Message, SwiftProtobuf._MessageI
       guard case .reloadZenzaiModel(let v)? = self.payload else { preconditionFailure() }
       try visitor.visitSingularMessageField(value: v, fieldNumber: 104)
     }()
+    case .activateProfile?: try {
+      guard case .activateProfile(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 105)
+    }()
+    case .getStats?: try {
+      guard case .getStats(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 200)
+    }()
+    case .flushTrace?: try {
+      guard case .flushTrace(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 201)
+    }()
     case nil: break
     }
+    if self.traceID != 0 {
+      try visitor.visitSingularUInt64Field(value: self.traceID, fieldNumber: 300)
+    }
+    try { if let v = self._inputModeState {
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 301)
+    } }()
     try unknownFields.traverse(visitor: &visitor)
   }
 
   static func ==(lhs: Hazkey_RequestEnvelope, rhs: Hazkey_RequestEnvelope) -> Bool {
     if lhs.payload != rhs.payload {return false}
+    if lhs.traceID != rhs.traceID {return false}
+    if lhs._inputModeState != rhs._inputModeState {return false}
     if lhs.unknownFields != rhs.unknownFields {return false}
     return true
   }
@@ -680,7 +858,9 @@ extension Hazkey_ResponseEnvelope: SwiftProtobuf.Message, SwiftProtobuf._Message
     4: .same(proto: "candidates"),
     5: .standard(proto: "text_with_cursor"),
     6: .standard(proto: "current_input_mode_info"),
+    7: .standard(proto: "convert_batch_result"),
     100: .standard(proto: "current_config"),
+    200: .standard(proto: "server_stats"),
   ]
 
   mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
@@ -738,6 +918,19 @@ extension Hazkey_ResponseEnvelope: SwiftProtobuf.Message, SwiftProtobuf._Message
           self.payload = .currentInputModeInfo(v)
         }
       }()
+      case 7: try {
+        var v: Hazkey_Commands_ConvertBatchResult?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .convertBatchResult(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .convertBatchResult(v)
+        }
+      }()
       case 100: try {
         var v: Hazkey_Config_CurrentConfig?
         var hadOneofValue = false
@@ -751,6 +944,19 @@ extension Hazkey_ResponseEnvelope: SwiftProtobuf.Message, SwiftProtobuf._Message
           self.payload = .currentConfig(v)
         }
       }()
+      case 200: try {
+        var v: Hazkey_Stats_ServerStats?
+        var hadOneofValue = false
+        if let current = self.payload {
+          hadOneofValue = true
+          if case .serverStats(let m) = current {v = m}
+        }
+        try decoder.decodeSingularMessageField(value: &v)
+        if let v = v {
+          if hadOneofValue {try decoder.handleConflictingOneOf()}
+          self.payload = .serverStats(v)
+        }
+      }()
       default: break
       }
     }
@@ -784,10 +990,18 @@ extension Hazkey_ResponseEnvelope: SwiftProtobuf.Message, SwiftProtobuf._Message
       guard case .currentInputModeInfo(let v)? = self.payload else { preconditionFailure() }
       try visitor.visitSingularMessageField(value: v, fieldNumber: 6)
     }()
+    case .convertBatchResult?: try {
+      guard case .convertBatchResult(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 7)
+    }()
     case .currentConfig?: try {
       guard case .currentConfig(let v)? = self.payload else { preconditionFailure() }
       try visitor.visitSingularMessageField(value: v, fieldNumber: 100)
     }()
+    case .serverStats?: try {
+      guard case .serverStats(let v)? = self.payload else { preconditionFailure() }
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 200)
+    }()
     case nil: break
     }
     try unknownFields.traverse(visitor: &visitor)
@@ -39,6 +39,14 @@ struct Hazkey_Commands_SetContext: Sendable {
 
   var anchor: Int32 = 0
 
+  var isDelta: Bool = false
+
+  var dropPrefix: Int32 = 0
+
+  var contextHash: UInt64 = 0
+
+  var windowSize: Int32 = 0
+
   var unknownFields = SwiftProtobuf.UnknownStorage()
 
   init() {}
@@ -263,6 +271,26 @@ struct Hazkey_Commands_GetCandidates: Sendable {
 
   var isSuggest: Bool = false
 
+  var deltaBaseVersion: UInt64 = 0
+
+  var paged: Bool = false
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Commands_GetCandidatePage: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var version: UInt64 = 0
+
+  var offset: Int32 = 0
+
+  var count: Int32 = 0
+
   var unknownFields = SwiftProtobuf.UnknownStorage()
 
   init() {}
@@ -288,6 +316,36 @@ struct Hazkey_Commands_SaveLearningData: Sendable {
   init() {}
 }
 
+struct Hazkey_Commands_ConvertBatch: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var items: [Hazkey_Commands_ConvertBatch.Item] = []
+
+  var nBest: Int32 = 0
+
+  var useZenzai: Bool = false
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  struct Item: Sendable {
+    // SwiftProtobuf.Message conformance is added in an extension below. See the
+    // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+    // methods supported on all messages.
+
+    var reading: String = String()
+
+    var leftContext: String = String()
+
+    var unknownFields = SwiftProtobuf.UnknownStorage()
+
+    init() {}
+  }
+
+  init() {}
+}
+
 struct Hazkey_Commands_Text: Sendable {
   // SwiftProtobuf.Message conformance is added in an extension below. See the
   // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
@@ -329,6 +387,16 @@ struct Hazkey_Commands_CandidatesResult: Sendable {
 
   var pageSize: Int32 = 0
 
+  var version: UInt64 = 0
+
+  var isDelta: Bool = false
+
+  var baseVersion: UInt64 = 0
+
+  var edits: [Hazkey_Commands_CandidatesResult.Edit] = []
+
+  var totalCount: Int32 = 0
+
   var unknownFields = SwiftProtobuf.UnknownStorage()
 
   struct Candidate: Sendable {
@@ -345,6 +413,97 @@ struct Hazkey_Commands_CandidatesResult: Sendable {
     init() {}
   }
 
+  struct Edit: Sendable {
+    // SwiftProtobuf.Message conformance is added in an extension below. See the
+    // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+    // methods supported on all messages.
+
+    var op: Hazkey_Commands_CandidatesResult.Edit.Op = .unspecified
+
+    var index: Int32 = 0
+
+    var candidate: Hazkey_Commands_CandidatesResult.Candidate {
+      get {return _candidate ?? Hazkey_Commands_CandidatesResult.Candidate()}
+      set {_candidate = newValue}
+    }
+    /// Returns true if `candidate` has been explicitly set.
+    var hasCandidate: Bool {return self._candidate != nil}
+    /// Clears the value of `candidate`. Subsequent reads from it will return its default value.
+    mutating func clearCandidate() {self._candidate = nil}
+
+    var unknownFields = SwiftProtobuf.UnknownStorage()
+
+    enum Op: SwiftProtobuf.Enum, Swift.CaseIterable {
+      typealias RawValue = Int
+      case unspecified // = 0
+      case insert // = 1
+      case remove // = 2
+      case replace // = 3
+      case UNRECOGNIZED(Int)
+
+      init() {
+        self = .unspecified
+      }
+
+      init?(rawValue: Int) {
+        switch rawValue {
+        case 0: self = .unspecified
+        case 1: self = .insert
+        case 2: self = .remove
+        case 3: self = .replace
+        default: self = .UNRECOGNIZED(rawValue)
+        }
+      }
+
+      var rawValue: Int {
+        switch self {
+        case .unspecified: return 0
+        case .insert: return 1
+        case .remove: return 2
+        case .replace: return 3
+        case .UNRECOGNIZED(let i): return i
+        }
+      }
+
+      // The compiler won't synthesize support with the UNRECOGNIZED case.
+      static let allCases: [Hazkey_Commands_CandidatesResult.Edit.Op] = [
+        .unspecified,
+        .insert,
+        .remove,
+        .replace,
+      ]
+
+    }
+
+    init() {}
+
+    fileprivate var _candidate: Hazkey_Commands_CandidatesResult.Candidate? = nil
+  }
+
+  init() {}
+}
+
+struct Hazkey_Commands_ConvertBatchResult: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var items: [Hazkey_Commands_ConvertBatchResult.Item] = []
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  struct Item: Sendable {
+    // SwiftProtobuf.Message conformance is added in an extension below. See the
+    // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+    // methods supported on all messages.
+
+    var candidates: [String] = []
+
+    var unknownFields = SwiftProtobuf.UnknownStorage()
+
+    init() {}
+  }
+
   init() {}
 }
 
@@ -355,6 +514,8 @@ struct Hazkey_Commands_CurrentInputModeInfo: Sendable {
 
   var inputMode: Hazkey_Commands_CurrentInputModeInfo.InputMode = .normal
 
+  var submodeEntryPointChars: String = String()
+
   var unknownFields = SwiftProtobuf.UnknownStorage()
 
   enum InputMode: SwiftProtobuf.Enum, Swift.CaseIterable {
@@ -394,6 +555,20 @@ struct Hazkey_Commands_CurrentInputModeInfo: Sendable {
   init() {}
 }
 
+struct Hazkey_Commands_InputModeState: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var subInputMode: Bool = false
+
+  var shiftPressedAlone: Bool = false
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
 // MARK: - Code below here is support for the SwiftProtobuf runtime.
 
 fileprivate let _protobuf_package = "hazkey.commands"
@@ -422,6 +597,10 @@ extension Hazkey_Commands_SetContext: SwiftProtobuf.Message, SwiftProtobuf._Mess
   static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
     1: .same(proto: "context"),
     2: .same(proto: "anchor"),
+    3: .standard(proto: "is_delta"),
+    4: .standard(proto: "drop_prefix"),
+    5: .standard(proto: "context_hash"),
+    6: .standard(proto: "window_size"),
   ]
 
   mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
@@ -432,6 +611,10 @@ extension Hazkey_Commands_SetContext: SwiftProtobuf.Message, SwiftProtobuf._Mess
       switch fieldNumber {
       case 1: try { try decoder.decodeSingularStringField(value: &self.context) }()
       case 2: try { try decoder.decodeSingularInt32Field(value: &self.anchor) }()
+      case 3: try { try decoder.decodeSingularBoolField(value: &self.isDelta) }()
+      case 4: try { try decoder.decodeSingularInt32Field(value: &self.dropPrefix) }()
+      case 5: try { try decoder.decodeSingularUInt64Field(value: &self.contextHash) }()
+      case 6: try { try decoder.decodeSingularInt32Field(value: &self.windowSize) }()
       default: break
       }
     }
@@ -444,12 +627,28 @@ extension Hazkey_Commands_SetContext: SwiftProtobuf.Message, SwiftProtobuf._Mess
     if self.anchor != 0 {
       try visitor.visitSingularInt32Field(value: self.anchor, fieldNumber: 2)
     }
+    if self.isDelta != false {
+      try visitor.visitSingularBoolField(value: self.isDelta, fieldNumber: 3)
+    }
+    if self.dropPrefix != 0 {
+      try visitor.visitSingularInt32Field(value: self.dropPrefix, fieldNumber: 4)
+    }
+    if self.contextHash != 0 {
+      try visitor.visitSingularUInt64Field(value: self.contextHash, fieldNumber: 5)
+    }
+    if self.windowSize != 0 {
+      try visitor.visitSingularInt32Field(value: self.windowSize, fieldNumber: 6)
+    }
     try unknownFields.traverse(visitor: &visitor)
   }
 
   static func ==(lhs: Hazkey_Commands_SetContext, rhs: Hazkey_Commands_SetContext) -> Bool {
     if lhs.context != rhs.context {return false}
     if lhs.anchor != rhs.anchor {return false}
+    if lhs.isDelta != rhs.isDelta {return false}
+    if lhs.dropPrefix != rhs.dropPrefix {return false}
+    if lhs.contextHash != rhs.contextHash {return false}
+    if lhs.windowSize != rhs.windowSize {return false}
     if lhs.unknownFields != rhs.unknownFields {return false}
     return true
   }
@@ -713,6 +912,8 @@ extension Hazkey_Commands_GetCandidates: SwiftProtobuf.Message, SwiftProtobuf._M
   static let protoMessageName: String = _protobuf_package + ".GetCandidates"
   static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
     1: .standard(proto: "is_suggest"),
+    2: .standard(proto: "delta_base_version"),
+    3: .same(proto: "paged"),
   ]
 
   mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
@@ -722,6 +923,8 @@ extension Hazkey_Commands_GetCandidates: SwiftProtobuf.Message, SwiftProtobuf._M
       // enabled. https://github.com/apple/swift-protobuf/issues/1034
       switch fieldNumber {
       case 1: try { try decoder.decodeSingularBoolField(value: &self.isSuggest) }()
+      case 2: try { try decoder.decodeSingularUInt64Field(value: &self.deltaBaseVersion) }()
+      case 3: try { try decoder.decodeSingularBoolField(value: &self.paged) }()
       default: break
       }
     }
@@ -731,11 +934,63 @@ extension Hazkey_Commands_GetCandidates: SwiftProtobuf.Message, SwiftProtobuf._M
     if self.isSuggest != false {
       try visitor.visitSingularBoolField(value: self.isSuggest, fieldNumber: 1)
     }
+    if self.deltaBaseVersion != 0 {
+      try visitor.visitSingularUInt64Field(value: self.deltaBaseVersion, fieldNumber: 2)
+    }
+    if self.paged != false {
+      try visitor.visitSingularBoolField(value: self.paged, fieldNumber: 3)
+    }
     try unknownFields.traverse(visitor: &visitor)
   }
 
   static func ==(lhs: Hazkey_Commands_GetCandidates, rhs: Hazkey_Commands_GetCandidates) -> Bool {
     if lhs.isSuggest != rhs.isSuggest {return false}
+    if lhs.deltaBaseVersion != rhs.deltaBaseVersion {return false}
+    if lhs.paged != rhs.paged {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Commands_GetCandidatePage: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".GetCandidatePage"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "version"),
+    2: .same(proto: "offset"),
+    3: .same(proto: "count"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularUInt64Field(value: &self.version) }()
+      case 2: try { try decoder.decodeSingularInt32Field(value: &self.offset) }()
+      case 3: try { try decoder.decodeSingularInt32Field(value: &self.count) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if self.version != 0 {
+      try visitor.visitSingularUInt64Field(value: self.version, fieldNumber: 1)
+    }
+    if self.offset != 0 {
+      try visitor.visitSingularInt32Field(value: self.offset, fieldNumber: 2)
+    }
+    if self.count != 0 {
+      try visitor.visitSingularInt32Field(value: self.count, fieldNumber: 3)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_GetCandidatePage, rhs: Hazkey_Commands_GetCandidatePage) -> Bool {
+    if lhs.version != rhs.version {return false}
+    if lhs.offset != rhs.offset {return false}
+    if lhs.count != rhs.count {return false}
     if lhs.unknownFields != rhs.unknownFields {return false}
     return true
   }
@@ -779,6 +1034,88 @@ extension Hazkey_Commands_SaveLearningData: SwiftProtobuf.Message, SwiftProtobuf
   }
 }
 
+extension Hazkey_Commands_ConvertBatch: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".ConvertBatch"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "items"),
+    2: .standard(proto: "n_best"),
+    3: .standard(proto: "use_zenzai"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeRepeatedMessageField(value: &self.items) }()
+      case 2: try { try decoder.decodeSingularInt32Field(value: &self.nBest) }()
+      case 3: try { try decoder.decodeSingularBoolField(value: &self.useZenzai) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.items.isEmpty {
+      try visitor.visitRepeatedMessageField(value: self.items, fieldNumber: 1)
+    }
+    if self.nBest != 0 {
+      try visitor.visitSingularInt32Field(value: self.nBest, fieldNumber: 2)
+    }
+    if self.useZenzai != false {
+      try visitor.visitSingularBoolField(value: self.useZenzai, fieldNumber: 3)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_ConvertBatch, rhs: Hazkey_Commands_ConvertBatch) -> Bool {
+    if lhs.items != rhs.items {return false}
+    if lhs.nBest != rhs.nBest {return false}
+    if lhs.useZenzai != rhs.useZenzai {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Commands_ConvertBatch.Item: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = Hazkey_Commands_ConvertBatch.protoMessageName + ".Item"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "reading"),
+    2: .standard(proto: "left_context"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularStringField(value: &self.reading) }()
+      case 2: try { try decoder.decodeSingularStringField(value: &self.leftContext) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.reading.isEmpty {
+      try visitor.visitSingularStringField(value: self.reading, fieldNumber: 1)
+    }
+    if !self.leftContext.isEmpty {
+      try visitor.visitSingularStringField(value: self.leftContext, fieldNumber: 2)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_ConvertBatch.Item, rhs: Hazkey_Commands_ConvertBatch.Item) -> Bool {
+    if lhs.reading != rhs.reading {return false}
+    if lhs.leftContext != rhs.leftContext {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
 extension Hazkey_Commands_Text: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
   static let protoMessageName: String = _protobuf_package + ".Text"
   static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
@@ -862,6 +1199,11 @@ extension Hazkey_Commands_CandidatesResult: SwiftProtobuf.Message, SwiftProtobuf
     2: .standard(proto: "live_text"),
     3: .standard(proto: "live_text_index"),
     4: .standard(proto: "page_size"),
+    5: .same(proto: "version"),
+    6: .standard(proto: "is_delta"),
+    7: .standard(proto: "base_version"),
+    8: .same(proto: "edits"),
+    9: .standard(proto: "total_count"),
   ]
 
   mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
@@ -874,6 +1216,11 @@ extension Hazkey_Commands_CandidatesResult: SwiftProtobuf.Message, SwiftProtobuf
       case 2: try { try decoder.decodeSingularStringField(value: &self.liveText) }()
       case 3: try { try decoder.decodeSingularInt32Field(value: &self.liveTextIndex) }()
       case 4: try { try decoder.decodeSingularInt32Field(value: &self.pageSize) }()
+      case 5: try { try decoder.decodeSingularUInt64Field(value: &self.version) }()
+      case 6: try { try decoder.decodeSingularBoolField(value: &self.isDelta) }()
+      case 7: try { try decoder.decodeSingularUInt64Field(value: &self.baseVersion) }()
+      case 8: try { try decoder.decodeRepeatedMessageField(value: &self.edits) }()
+      case 9: try { try decoder.decodeSingularInt32Field(value: &self.totalCount) }()
       default: break
       }
     }
@@ -892,6 +1239,21 @@ extension Hazkey_Commands_CandidatesResult: SwiftProtobuf.Message, SwiftProtobuf
     if self.pageSize != 0 {
       try visitor.visitSingularInt32Field(value: self.pageSize, fieldNumber: 4)
     }
+    if self.version != 0 {
+      try visitor.visitSingularUInt64Field(value: self.version, fieldNumber: 5)
+    }
+    if self.isDelta != false {
+      try visitor.visitSingularBoolField(value: self.isDelta, fieldNumber: 6)
+    }
+    if self.baseVersion != 0 {
+      try visitor.visitSingularUInt64Field(value: self.baseVersion, fieldNumber: 7)
+    }
+    if !self.edits.isEmpty {
+      try visitor.visitRepeatedMessageField(value: self.edits, fieldNumber: 8)
+    }
+    if self.totalCount != 0 {
+      try visitor.visitSingularInt32Field(value: self.totalCount, fieldNumber: 9)
+    }
     try unknownFields.traverse(visitor: &visitor)
   }
 
@@ -900,6 +1262,11 @@ extension Hazkey_Commands_CandidatesResult: SwiftProtobuf.Message, SwiftProtobuf
     if lhs.liveText != rhs.liveText {return false}
     if lhs.liveTextIndex != rhs.liveTextIndex {return false}
     if lhs.pageSize != rhs.pageSize {return false}
+    if lhs.version != rhs.version {return false}
+    if lhs.isDelta != rhs.isDelta {return false}
+    if lhs.baseVersion != rhs.baseVersion {return false}
+    if lhs.edits != rhs.edits {return false}
+    if lhs.totalCount != rhs.totalCount {return false}
     if lhs.unknownFields != rhs.unknownFields {return false}
     return true
   }
@@ -943,10 +1310,132 @@ extension Hazkey_Commands_CandidatesResult.Candidate: SwiftProtobuf.Message, Swi
   }
 }
 
+extension Hazkey_Commands_CandidatesResult.Edit: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = Hazkey_Commands_CandidatesResult.protoMessageName + ".Edit"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "op"),
+    2: .same(proto: "index"),
+    3: .same(proto: "candidate"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularEnumField(value: &self.op) }()
+      case 2: try { try decoder.decodeSingularInt32Field(value: &self.index) }()
+      case 3: try { try decoder.decodeSingularMessageField(value: &self._candidate) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    // The use of inline closures is to circumvent an issue where the compiler
+    // allocates stack space for every if/case branch local when no optimizations
+    // are enabled. https://github.com/apple/swift-protobuf/issues/1034 and
+    // https://github.com/apple/swift-protobuf/issues/1182
+    if self.op != .unspecified {
+      try visitor.visitSingularEnumField(value: self.op, fieldNumber: 1)
+    }
+    if self.index != 0 {
+      try visitor.visitSingularInt32Field(value: self.index, fieldNumber: 2)
+    }
+    try { if let v = self._candidate {
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 3)
+    } }()
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_CandidatesResult.Edit, rhs: Hazkey_Commands_CandidatesResult.Edit) -> Bool {
+    if lhs.op != rhs.op {return false}
+    if lhs.index != rhs.index {return false}
+    if lhs._candidate != rhs._candidate {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Commands_CandidatesResult.Edit.Op: SwiftProtobuf._ProtoNameProviding {
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    0: .same(proto: "OP_UNSPECIFIED"),
+    1: .same(proto: "INSERT"),
+    2: .same(proto: "REMOVE"),
+    3: .same(proto: "REPLACE"),
+  ]
+}
+
+extension Hazkey_Commands_ConvertBatchResult: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".ConvertBatchResult"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "items"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeRepeatedMessageField(value: &self.items) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.items.isEmpty {
+      try visitor.visitRepeatedMessageField(value: self.items, fieldNumber: 1)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_ConvertBatchResult, rhs: Hazkey_Commands_ConvertBatchResult) -> Bool {
+    if lhs.items != rhs.items {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Commands_ConvertBatchResult.Item: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = Hazkey_Commands_ConvertBatchResult.protoMessageName + ".Item"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "candidates"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeRepeatedStringField(value: &self.candidates) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.candidates.isEmpty {
+      try visitor.visitRepeatedStringField(value: self.candidates, fieldNumber: 1)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_ConvertBatchResult.Item, rhs: Hazkey_Commands_ConvertBatchResult.Item) -> Bool {
+    if lhs.candidates != rhs.candidates {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
 extension Hazkey_Commands_CurrentInputModeInfo: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
   static let protoMessageName: String = _protobuf_package + ".CurrentInputModeInfo"
   static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
     1: .standard(proto: "input_mode"),
+    2: .standard(proto: "submode_entry_point_chars"),
   ]
 
   mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
@@ -956,6 +1445,7 @@ extension Hazkey_Commands_CurrentInputModeInfo: SwiftProtobuf.Message, SwiftProt
       // enabled. https://github.com/apple/swift-protobuf/issues/1034
       switch fieldNumber {
       case 1: try { try decoder.decodeSingularEnumField(value: &self.inputMode) }()
+      case 2: try { try decoder.decodeSingularStringField(value: &self.submodeEntryPointChars) }()
       default: break
       }
     }
@@ -965,11 +1455,15 @@ extension Hazkey_Commands_CurrentInputModeInfo: SwiftProtobuf.Message, SwiftProt
     if self.inputMode != .normal {
       try visitor.visitSingularEnumField(value: self.inputMode, fieldNumber: 1)
     }
+    if !self.submodeEntryPointChars.isEmpty {
+      try visitor.visitSingularStringField(value: self.submodeEntryPointChars, fieldNumber: 2)
+    }
     try unknownFields.traverse(visitor: &visitor)
   }
 
   static func ==(lhs: Hazkey_Commands_CurrentInputModeInfo, rhs: Hazkey_Commands_CurrentInputModeInfo) -> Bool {
     if lhs.inputMode != rhs.inputMode {return false}
+    if lhs.submodeEntryPointChars != rhs.submodeEntryPointChars {return false}
     if lhs.unknownFields != rhs.unknownFields {return false}
     return true
   }
@@ -981,3 +1475,41 @@ extension Hazkey_Commands_CurrentInputModeInfo.InputMode: SwiftProtobuf._ProtoNa
     1: .same(proto: "DIRECT"),
   ]
 }
+
+extension Hazkey_Commands_InputModeState: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".InputModeState"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .standard(proto: "sub_input_mode"),
+    2: .standard(proto: "shift_pressed_alone"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularBoolField(value: &self.subInputMode) }()
+      case 2: try { try decoder.decodeSingularBoolField(value: &self.shiftPressedAlone) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if self.subInputMode != false {
+      try visitor.visitSingularBoolField(value: self.subInputMode, fieldNumber: 1)
+    }
+    if self.shiftPressedAlone != false {
+      try visitor.visitSingularBoolField(value: self.shiftPressedAlone, fieldNumber: 2)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Commands_InputModeState, rhs: Hazkey_Commands_InputModeState) -> Bool {
+    if lhs.subInputMode != rhs.subInputMode {return false}
+    if lhs.shiftPressedAlone != rhs.shiftPressedAlone {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
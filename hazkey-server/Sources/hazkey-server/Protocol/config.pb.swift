@@ -221,6 +221,15 @@ struct Hazkey_Config_Profile: @unchecked Sendable {
   /// Clears the value of `useRichCandidates`. Subsequent reads from it will return its default value.
   mutating func clearUseRichCandidates() {_uniqueStorage()._useRichCandidates = nil}
 
+  var speculativeConversionDelayMs: Int32 {
+    get {return _storage._speculativeConversionDelayMs ?? 0}
+    set {_uniqueStorage()._speculativeConversionDelayMs = newValue}
+  }
+  /// Returns true if `speculativeConversionDelayMs` has been explicitly set.
+  var hasSpeculativeConversionDelayMs: Bool {return _storage._speculativeConversionDelayMs != nil}
+  /// Clears the value of `speculativeConversionDelayMs`. Subsequent reads from it will return its default value.
+  mutating func clearSpeculativeConversionDelayMs() {_uniqueStorage()._speculativeConversionDelayMs = nil}
+
   var useDefaultHistorySettings: Bool {
     get {return _storage._useDefaultHistorySettings ?? false}
     set {_uniqueStorage()._useDefaultHistorySettings = newValue}
@@ -375,6 +384,15 @@ struct Hazkey_Config_Profile: @unchecked Sendable {
   /// Clears the value of `zenzaiBackendDeviceName`. Subsequent reads from it will return its default value.
   mutating func clearZenzaiBackendDeviceName() {_uniqueStorage()._zenzaiBackendDeviceName = nil}
 
+  var zenzaiLatencyTargetMs: Int32 {
+    get {return _storage._zenzaiLatencyTargetMs ?? 0}
+    set {_uniqueStorage()._zenzaiLatencyTargetMs = newValue}
+  }
+  /// Returns true if `zenzaiLatencyTargetMs` has been explicitly set.
+  var hasZenzaiLatencyTargetMs: Bool {return _storage._zenzaiLatencyTargetMs != nil}
+  /// Clears the value of `zenzaiLatencyTargetMs`. Subsequent reads from it will return its default value.
+  mutating func clearZenzaiLatencyTargetMs() {_uniqueStorage()._zenzaiLatencyTargetMs = nil}
+
   var zenzaiProfile: String {
     get {return _storage._zenzaiProfile ?? String()}
     set {_uniqueStorage()._zenzaiProfile = newValue}
@@ -783,6 +801,18 @@ struct Hazkey_Config_ReloadZenzaiModel: Sendable {
   init() {}
 }
 
+struct Hazkey_Config_ActivateProfile: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var profileID: String = String()
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
 struct Hazkey_Config_CurrentConfig: Sendable {
   // SwiftProtobuf.Message conformance is added in an extension below. See the
   // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
@@ -1005,6 +1035,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
     20: .standard(proto: "use_default_conversion_ui_settings"),
     21: .standard(proto: "num_candidates_per_page"),
     22: .standard(proto: "use_rich_candidates"),
+    24: .standard(proto: "speculative_conversion_delay_ms"),
     30: .standard(proto: "use_default_history_settings"),
     31: .standard(proto: "use_profile_independent_history"),
     32: .standard(proto: "use_input_history"),
@@ -1023,6 +1054,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
     105: .standard(proto: "use_zenzai_custom_weight"),
     106: .standard(proto: "zenzai_weight_path"),
     107: .standard(proto: "zenzai_backend_device_name"),
+    108: .standard(proto: "zenzai_latency_target_ms"),
     120: .standard(proto: "zenzai_profile"),
     121: .standard(proto: "zenzai_topic"),
     122: .standard(proto: "zenzai_style"),
@@ -1042,6 +1074,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
     var _useDefaultConversionUiSettings: Bool? = nil
     var _numCandidatesPerPage: Int32? = nil
     var _useRichCandidates: Bool? = nil
+    var _speculativeConversionDelayMs: Int32? = nil
     var _useDefaultHistorySettings: Bool? = nil
     var _useProfileIndependentHistory: Bool? = nil
     var _useInputHistory: Bool? = nil
@@ -1060,6 +1093,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
     var _useZenzaiCustomWeight: Bool? = nil
     var _zenzaiWeightPath: String? = nil
     var _zenzaiBackendDeviceName: String? = nil
+    var _zenzaiLatencyTargetMs: Int32? = nil
     var _zenzaiProfile: String? = nil
     var _zenzaiTopic: String? = nil
     var _zenzaiStyle: String? = nil
@@ -1086,6 +1120,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
       _useDefaultConversionUiSettings = source._useDefaultConversionUiSettings
       _numCandidatesPerPage = source._numCandidatesPerPage
       _useRichCandidates = source._useRichCandidates
+      _speculativeConversionDelayMs = source._speculativeConversionDelayMs
       _useDefaultHistorySettings = source._useDefaultHistorySettings
       _useProfileIndependentHistory = source._useProfileIndependentHistory
       _useInputHistory = source._useInputHistory
@@ -1104,6 +1139,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
       _useZenzaiCustomWeight = source._useZenzaiCustomWeight
       _zenzaiWeightPath = source._zenzaiWeightPath
       _zenzaiBackendDeviceName = source._zenzaiBackendDeviceName
+      _zenzaiLatencyTargetMs = source._zenzaiLatencyTargetMs
       _zenzaiProfile = source._zenzaiProfile
       _zenzaiTopic = source._zenzaiTopic
       _zenzaiStyle = source._zenzaiStyle
@@ -1139,6 +1175,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
         case 21: try { try decoder.decodeSingularInt32Field(value: &_storage._numCandidatesPerPage) }()
         case 22: try { try decoder.decodeSingularBoolField(value: &_storage._useRichCandidates) }()
         case 23: try { try decoder.decodeSingularBoolField(value: &_storage._stopStoreNewHistory) }()
+        case 24: try { try decoder.decodeSingularInt32Field(value: &_storage._speculativeConversionDelayMs) }()
         case 30: try { try decoder.decodeSingularBoolField(value: &_storage._useDefaultHistorySettings) }()
         case 31: try { try decoder.decodeSingularBoolField(value: &_storage._useProfileIndependentHistory) }()
         case 32: try { try decoder.decodeSingularBoolField(value: &_storage._useInputHistory) }()
@@ -1156,6 +1193,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
         case 105: try { try decoder.decodeSingularBoolField(value: &_storage._useZenzaiCustomWeight) }()
         case 106: try { try decoder.decodeSingularStringField(value: &_storage._zenzaiWeightPath) }()
         case 107: try { try decoder.decodeSingularStringField(value: &_storage._zenzaiBackendDeviceName) }()
+        case 108: try { try decoder.decodeSingularInt32Field(value: &_storage._zenzaiLatencyTargetMs) }()
         case 120: try { try decoder.decodeSingularStringField(value: &_storage._zenzaiProfile) }()
         case 121: try { try decoder.decodeSingularStringField(value: &_storage._zenzaiTopic) }()
         case 122: try { try decoder.decodeSingularStringField(value: &_storage._zenzaiStyle) }()
@@ -1211,6 +1249,9 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
       try { if let v = _storage._stopStoreNewHistory {
         try visitor.visitSingularBoolField(value: v, fieldNumber: 23)
       } }()
+      try { if let v = _storage._speculativeConversionDelayMs {
+        try visitor.visitSingularInt32Field(value: v, fieldNumber: 24)
+      } }()
       try { if let v = _storage._useDefaultHistorySettings {
         try visitor.visitSingularBoolField(value: v, fieldNumber: 30)
       } }()
@@ -1262,6 +1303,9 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
       try { if let v = _storage._zenzaiBackendDeviceName {
         try visitor.visitSingularStringField(value: v, fieldNumber: 107)
       } }()
+      try { if let v = _storage._zenzaiLatencyTargetMs {
+        try visitor.visitSingularInt32Field(value: v, fieldNumber: 108)
+      } }()
       try { if let v = _storage._zenzaiProfile {
         try visitor.visitSingularStringField(value: v, fieldNumber: 120)
       } }()
@@ -1295,6 +1339,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
         if _storage._useDefaultConversionUiSettings != rhs_storage._useDefaultConversionUiSettings {return false}
         if _storage._numCandidatesPerPage != rhs_storage._numCandidatesPerPage {return false}
         if _storage._useRichCandidates != rhs_storage._useRichCandidates {return false}
+        if _storage._speculativeConversionDelayMs != rhs_storage._speculativeConversionDelayMs {return false}
         if _storage._useDefaultHistorySettings != rhs_storage._useDefaultHistorySettings {return false}
         if _storage._useProfileIndependentHistory != rhs_storage._useProfileIndependentHistory {return false}
         if _storage._useInputHistory != rhs_storage._useInputHistory {return false}
@@ -1313,6 +1358,7 @@ extension Hazkey_Config_Profile: SwiftProtobuf.Message, SwiftProtobuf._MessageIm
         if _storage._useZenzaiCustomWeight != rhs_storage._useZenzaiCustomWeight {return false}
         if _storage._zenzaiWeightPath != rhs_storage._zenzaiWeightPath {return false}
         if _storage._zenzaiBackendDeviceName != rhs_storage._zenzaiBackendDeviceName {return false}
+        if _storage._zenzaiLatencyTargetMs != rhs_storage._zenzaiLatencyTargetMs {return false}
         if _storage._zenzaiProfile != rhs_storage._zenzaiProfile {return false}
         if _storage._zenzaiTopic != rhs_storage._zenzaiTopic {return false}
         if _storage._zenzaiStyle != rhs_storage._zenzaiStyle {return false}
@@ -1660,6 +1706,38 @@ extension Hazkey_Config_ReloadZenzaiModel: SwiftProtobuf.Message, SwiftProtobuf.
   }
 }
 
+extension Hazkey_Config_ActivateProfile: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".ActivateProfile"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .standard(proto: "profile_id"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularStringField(value: &self.profileID) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.profileID.isEmpty {
+      try visitor.visitSingularStringField(value: self.profileID, fieldNumber: 1)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Config_ActivateProfile, rhs: Hazkey_Config_ActivateProfile) -> Bool {
+    if lhs.profileID != rhs.profileID {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
 extension Hazkey_Config_CurrentConfig: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
   static let protoMessageName: String = _protobuf_package + ".CurrentConfig"
   static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
@@ -0,0 +1,250 @@
+// DO NOT EDIT.
+// swift-format-ignore-file
+// swiftlint:disable all
+//
+// Generated by the Swift generator plugin for the protocol buffer compiler.
+// Source: handoff.proto
+//
+// For information on using the generated types, please see the documentation:
+//   https://github.com/apple/swift-protobuf/
+
+import SwiftProtobuf
+
+// If the compiler emits an error on this type, it is because this file
+// was generated by a version of the `protoc` Swift plug-in that is
+// incompatible with the version of SwiftProtobuf to which you are linking.
+// Please ensure that you are building against the same version of the API
+// that was used to generate this file.
+fileprivate struct _GeneratedWithProtocGenSwiftVersion: SwiftProtobuf.ProtobufAPIVersionCheck {
+  struct _2: SwiftProtobuf.ProtobufAPIVersion_2 {}
+  typealias Version = _2
+}
+
+struct Hazkey_Handoff_InputElement: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var character: String = String()
+
+  var isKey: Bool = false
+
+  var intention: String = String()
+
+  var direct: Bool = false
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Handoff_SessionState: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var input: [Hazkey_Handoff_InputElement] = []
+
+  var cursor: Int32 = 0
+
+  var subInputMode: Bool = false
+
+  var shiftPressedAlone: Bool = false
+
+  var leftContext: String = String()
+
+  var activeProfileID: String = String()
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Handoff_HandOff: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var version: String = String()
+
+  var clientAttached: Bool = false
+
+  var session: Hazkey_Handoff_SessionState {
+    get {return _session ?? Hazkey_Handoff_SessionState()}
+    set {_session = newValue}
+  }
+  /// Returns true if `session` has been explicitly set.
+  var hasSession: Bool {return self._session != nil}
+  /// Clears the value of `session`. Subsequent reads from it will return its default value.
+  mutating func clearSession() {self._session = nil}
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+
+  fileprivate var _session: Hazkey_Handoff_SessionState? = nil
+}
+
+// MARK: - Code below here is support for the SwiftProtobuf runtime.
+
+fileprivate let _protobuf_package = "hazkey.handoff"
+
+extension Hazkey_Handoff_InputElement: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".InputElement"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "character"),
+    2: .standard(proto: "is_key"),
+    3: .same(proto: "intention"),
+    4: .same(proto: "direct"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularStringField(value: &self.character) }()
+      case 2: try { try decoder.decodeSingularBoolField(value: &self.isKey) }()
+      case 3: try { try decoder.decodeSingularStringField(value: &self.intention) }()
+      case 4: try { try decoder.decodeSingularBoolField(value: &self.direct) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.character.isEmpty {
+      try visitor.visitSingularStringField(value: self.character, fieldNumber: 1)
+    }
+    if self.isKey != false {
+      try visitor.visitSingularBoolField(value: self.isKey, fieldNumber: 2)
+    }
+    if !self.intention.isEmpty {
+      try visitor.visitSingularStringField(value: self.intention, fieldNumber: 3)
+    }
+    if self.direct != false {
+      try visitor.visitSingularBoolField(value: self.direct, fieldNumber: 4)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Handoff_InputElement, rhs: Hazkey_Handoff_InputElement) -> Bool {
+    if lhs.character != rhs.character {return false}
+    if lhs.isKey != rhs.isKey {return false}
+    if lhs.intention != rhs.intention {return false}
+    if lhs.direct != rhs.direct {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Handoff_SessionState: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".SessionState"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "input"),
+    2: .same(proto: "cursor"),
+    3: .standard(proto: "sub_input_mode"),
+    4: .standard(proto: "shift_pressed_alone"),
+    5: .standard(proto: "left_context"),
+    6: .standard(proto: "active_profile_id"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeRepeatedMessageField(value: &self.input) }()
+      case 2: try { try decoder.decodeSingularInt32Field(value: &self.cursor) }()
+      case 3: try { try decoder.decodeSingularBoolField(value: &self.subInputMode) }()
+      case 4: try { try decoder.decodeSingularBoolField(value: &self.shiftPressedAlone) }()
+      case 5: try { try decoder.decodeSingularStringField(value: &self.leftContext) }()
+      case 6: try { try decoder.decodeSingularStringField(value: &self.activeProfileID) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.input.isEmpty {
+      try visitor.visitRepeatedMessageField(value: self.input, fieldNumber: 1)
+    }
+    if self.cursor != 0 {
+      try visitor.visitSingularInt32Field(value: self.cursor, fieldNumber: 2)
+    }
+    if self.subInputMode != false {
+      try visitor.visitSingularBoolField(value: self.subInputMode, fieldNumber: 3)
+    }
+    if self.shiftPressedAlone != false {
+      try visitor.visitSingularBoolField(value: self.shiftPressedAlone, fieldNumber: 4)
+    }
+    if !self.leftContext.isEmpty {
+      try visitor.visitSingularStringField(value: self.leftContext, fieldNumber: 5)
+    }
+    if !self.activeProfileID.isEmpty {
+      try visitor.visitSingularStringField(value: self.activeProfileID, fieldNumber: 6)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Handoff_SessionState, rhs: Hazkey_Handoff_SessionState) -> Bool {
+    if lhs.input != rhs.input {return false}
+    if lhs.cursor != rhs.cursor {return false}
+    if lhs.subInputMode != rhs.subInputMode {return false}
+    if lhs.shiftPressedAlone != rhs.shiftPressedAlone {return false}
+    if lhs.leftContext != rhs.leftContext {return false}
+    if lhs.activeProfileID != rhs.activeProfileID {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Handoff_HandOff: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".HandOff"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "version"),
+    2: .standard(proto: "client_attached"),
+    3: .same(proto: "session"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularStringField(value: &self.version) }()
+      case 2: try { try decoder.decodeSingularBoolField(value: &self.clientAttached) }()
+      case 3: try { try decoder.decodeSingularMessageField(value: &self._session) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    // The use of inline closures is to circumvent an issue where the compiler
+    // allocates stack space for every if/case branch local when no optimizations
+    // are enabled. https://github.com/apple/swift-protobuf/issues/1034 and
+    // https://github.com/apple/swift-protobuf/issues/1182
+    if !self.version.isEmpty {
+      try visitor.visitSingularStringField(value: self.version, fieldNumber: 1)
+    }
+    if self.clientAttached != false {
+      try visitor.visitSingularBoolField(value: self.clientAttached, fieldNumber: 2)
+    }
+    try { if let v = self._session {
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 3)
+    } }()
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Handoff_HandOff, rhs: Hazkey_Handoff_HandOff) -> Bool {
+    if lhs.version != rhs.version {return false}
+    if lhs.clientAttached != rhs.clientAttached {return false}
+    if lhs._session != rhs._session {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
@@ -0,0 +1,740 @@
+// DO NOT EDIT.
+// swift-format-ignore-file
+// swiftlint:disable all
+//
+// Generated by the Swift generator plugin for the protocol buffer compiler.
+// Source: stats.proto
+//
+// For information on using the generated types, please see the documentation:
+//   https://github.com/apple/swift-protobuf/
+
+import SwiftProtobuf
+
+// If the compiler emits an error on this type, it is because this file
+// was generated by a version of the `protoc` Swift plug-in that is
+// incompatible with the version of SwiftProtobuf to which you are linking.
+// Please ensure that you are building against the same version of the API
+// that was used to generate this file.
+fileprivate struct _GeneratedWithProtocGenSwiftVersion: SwiftProtobuf.ProtobufAPIVersionCheck {
+  struct _2: SwiftProtobuf.ProtobufAPIVersion_2 {}
+  typealias Version = _2
+}
+
+struct Hazkey_Stats_GetStats: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var reset: Bool = false
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Stats_FlushTrace: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Stats_Histogram: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var bucketUpperBoundsUs: [UInt64] = []
+
+  var bucketCounts: [UInt64] = []
+
+  var count: UInt64 = 0
+
+  var sumUs: UInt64 = 0
+
+  var maxUs: UInt64 = 0
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Stats_RequestStats: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var payloadType: String = String()
+
+  var count: UInt64 = 0
+
+  var failures: UInt64 = 0
+
+  var latency: Hazkey_Stats_Histogram {
+    get {return _latency ?? Hazkey_Stats_Histogram()}
+    set {_latency = newValue}
+  }
+  /// Returns true if `latency` has been explicitly set.
+  var hasLatency: Bool {return self._latency != nil}
+  /// Clears the value of `latency`. Subsequent reads from it will return its default value.
+  mutating func clearLatency() {self._latency = nil}
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+
+  fileprivate var _latency: Hazkey_Stats_Histogram? = nil
+}
+
+struct Hazkey_Stats_CacheStats: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var name: String = String()
+
+  var hits: UInt64 = 0
+
+  var misses: UInt64 = 0
+
+  var evictions: UInt64 = 0
+
+  var invalidations: UInt64 = 0
+
+  var size: UInt32 = 0
+
+  var capacity: UInt32 = 0
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Stats_ZenzaiStats: Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var modelAvailable: Bool = false
+
+  var enabled: Bool = false
+
+  var modelPath: String = String()
+
+  var backendDevice: String = String()
+
+  var latencyTargetMs: Int32 = 0
+
+  var maxInferenceLimit: Int32 = 0
+
+  var currentInferenceLimit: Int32 = 0
+
+  var skipsSuggest: Bool = false
+
+  var skippedSuggests: UInt64 = 0
+
+  var limitAdjustments: UInt64 = 0
+
+  var p50LatencyUs: UInt64 = 0
+
+  var p95LatencyUs: UInt64 = 0
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+}
+
+struct Hazkey_Stats_ServerStats: @unchecked Sendable {
+  // SwiftProtobuf.Message conformance is added in an extension below. See the
+  // `Message` and `Message+*Additions` files in the SwiftProtobuf library for
+  // methods supported on all messages.
+
+  var version: String {
+    get {return _storage._version}
+    set {_uniqueStorage()._version = newValue}
+  }
+
+  var uptimeMs: UInt64 {
+    get {return _storage._uptimeMs}
+    set {_uniqueStorage()._uptimeMs = newValue}
+  }
+
+  var rssBytes: UInt64 {
+    get {return _storage._rssBytes}
+    set {_uniqueStorage()._rssBytes = newValue}
+  }
+
+  var activeProfileID: String {
+    get {return _storage._activeProfileID}
+    set {_uniqueStorage()._activeProfileID = newValue}
+  }
+
+  var requests: [Hazkey_Stats_RequestStats] {
+    get {return _storage._requests}
+    set {_uniqueStorage()._requests = newValue}
+  }
+
+  var dictionaryConversion: Hazkey_Stats_Histogram {
+    get {return _storage._dictionaryConversion ?? Hazkey_Stats_Histogram()}
+    set {_uniqueStorage()._dictionaryConversion = newValue}
+  }
+  /// Returns true if `dictionaryConversion` has been explicitly set.
+  var hasDictionaryConversion: Bool {return _storage._dictionaryConversion != nil}
+  /// Clears the value of `dictionaryConversion`. Subsequent reads from it will return its default value.
+  mutating func clearDictionaryConversion() {_uniqueStorage()._dictionaryConversion = nil}
+
+  var zenzaiConversion: Hazkey_Stats_Histogram {
+    get {return _storage._zenzaiConversion ?? Hazkey_Stats_Histogram()}
+    set {_uniqueStorage()._zenzaiConversion = newValue}
+  }
+  /// Returns true if `zenzaiConversion` has been explicitly set.
+  var hasZenzaiConversion: Bool {return _storage._zenzaiConversion != nil}
+  /// Clears the value of `zenzaiConversion`. Subsequent reads from it will return its default value.
+  mutating func clearZenzaiConversion() {_uniqueStorage()._zenzaiConversion = nil}
+
+  var learningSave: Hazkey_Stats_Histogram {
+    get {return _storage._learningSave ?? Hazkey_Stats_Histogram()}
+    set {_uniqueStorage()._learningSave = newValue}
+  }
+  /// Returns true if `learningSave` has been explicitly set.
+  var hasLearningSave: Bool {return _storage._learningSave != nil}
+  /// Clears the value of `learningSave`. Subsequent reads from it will return its default value.
+  mutating func clearLearningSave() {_uniqueStorage()._learningSave = nil}
+
+  var caches: [Hazkey_Stats_CacheStats] {
+    get {return _storage._caches}
+    set {_uniqueStorage()._caches = newValue}
+  }
+
+  var zenzai: Hazkey_Stats_ZenzaiStats {
+    get {return _storage._zenzai ?? Hazkey_Stats_ZenzaiStats()}
+    set {_uniqueStorage()._zenzai = newValue}
+  }
+  /// Returns true if `zenzai` has been explicitly set.
+  var hasZenzai: Bool {return _storage._zenzai != nil}
+  /// Clears the value of `zenzai`. Subsequent reads from it will return its default value.
+  mutating func clearZenzai() {_uniqueStorage()._zenzai = nil}
+
+  var clientConnections: UInt64 {
+    get {return _storage._clientConnections}
+    set {_uniqueStorage()._clientConnections = newValue}
+  }
+
+  var socketBacklogBytes: UInt64 {
+    get {return _storage._socketBacklogBytes}
+    set {_uniqueStorage()._socketBacklogBytes = newValue}
+  }
+
+  var maxSocketBacklogBytes: UInt64 {
+    get {return _storage._maxSocketBacklogBytes}
+    set {_uniqueStorage()._maxSocketBacklogBytes = newValue}
+  }
+
+  var unknownFields = SwiftProtobuf.UnknownStorage()
+
+  init() {}
+
+  fileprivate var _storage = _StorageClass.defaultInstance
+}
+
+// MARK: - Code below here is support for the SwiftProtobuf runtime.
+
+fileprivate let _protobuf_package = "hazkey.stats"
+
+extension Hazkey_Stats_GetStats: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".GetStats"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "reset"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularBoolField(value: &self.reset) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if self.reset != false {
+      try visitor.visitSingularBoolField(value: self.reset, fieldNumber: 1)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_GetStats, rhs: Hazkey_Stats_GetStats) -> Bool {
+    if lhs.reset != rhs.reset {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Stats_FlushTrace: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".FlushTrace"
+  static let _protobuf_nameMap = SwiftProtobuf._NameMap()
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    // Load everything into unknown fields
+    while try decoder.nextFieldNumber() != nil {}
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_FlushTrace, rhs: Hazkey_Stats_FlushTrace) -> Bool {
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Stats_Histogram: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".Histogram"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .standard(proto: "bucket_upper_bounds_us"),
+    2: .standard(proto: "bucket_counts"),
+    3: .same(proto: "count"),
+    4: .standard(proto: "sum_us"),
+    5: .standard(proto: "max_us"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeRepeatedUInt64Field(value: &self.bucketUpperBoundsUs) }()
+      case 2: try { try decoder.decodeRepeatedUInt64Field(value: &self.bucketCounts) }()
+      case 3: try { try decoder.decodeSingularUInt64Field(value: &self.count) }()
+      case 4: try { try decoder.decodeSingularUInt64Field(value: &self.sumUs) }()
+      case 5: try { try decoder.decodeSingularUInt64Field(value: &self.maxUs) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.bucketUpperBoundsUs.isEmpty {
+      try visitor.visitPackedUInt64Field(value: self.bucketUpperBoundsUs, fieldNumber: 1)
+    }
+    if !self.bucketCounts.isEmpty {
+      try visitor.visitPackedUInt64Field(value: self.bucketCounts, fieldNumber: 2)
+    }
+    if self.count != 0 {
+      try visitor.visitSingularUInt64Field(value: self.count, fieldNumber: 3)
+    }
+    if self.sumUs != 0 {
+      try visitor.visitSingularUInt64Field(value: self.sumUs, fieldNumber: 4)
+    }
+    if self.maxUs != 0 {
+      try visitor.visitSingularUInt64Field(value: self.maxUs, fieldNumber: 5)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_Histogram, rhs: Hazkey_Stats_Histogram) -> Bool {
+    if lhs.bucketUpperBoundsUs != rhs.bucketUpperBoundsUs {return false}
+    if lhs.bucketCounts != rhs.bucketCounts {return false}
+    if lhs.count != rhs.count {return false}
+    if lhs.sumUs != rhs.sumUs {return false}
+    if lhs.maxUs != rhs.maxUs {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Stats_RequestStats: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".RequestStats"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .standard(proto: "payload_type"),
+    2: .same(proto: "count"),
+    3: .same(proto: "failures"),
+    4: .same(proto: "latency"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularStringField(value: &self.payloadType) }()
+      case 2: try { try decoder.decodeSingularUInt64Field(value: &self.count) }()
+      case 3: try { try decoder.decodeSingularUInt64Field(value: &self.failures) }()
+      case 4: try { try decoder.decodeSingularMessageField(value: &self._latency) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    // The use of inline closures is to circumvent an issue where the compiler
+    // allocates stack space for every if/case branch local when no optimizations
+    // are enabled. https://github.com/apple/swift-protobuf/issues/1034 and
+    // https://github.com/apple/swift-protobuf/issues/1182
+    if !self.payloadType.isEmpty {
+      try visitor.visitSingularStringField(value: self.payloadType, fieldNumber: 1)
+    }
+    if self.count != 0 {
+      try visitor.visitSingularUInt64Field(value: self.count, fieldNumber: 2)
+    }
+    if self.failures != 0 {
+      try visitor.visitSingularUInt64Field(value: self.failures, fieldNumber: 3)
+    }
+    try { if let v = self._latency {
+      try visitor.visitSingularMessageField(value: v, fieldNumber: 4)
+    } }()
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_RequestStats, rhs: Hazkey_Stats_RequestStats) -> Bool {
+    if lhs.payloadType != rhs.payloadType {return false}
+    if lhs.count != rhs.count {return false}
+    if lhs.failures != rhs.failures {return false}
+    if lhs._latency != rhs._latency {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Stats_CacheStats: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".CacheStats"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "name"),
+    2: .same(proto: "hits"),
+    3: .same(proto: "misses"),
+    4: .same(proto: "evictions"),
+    5: .same(proto: "invalidations"),
+    6: .same(proto: "size"),
+    7: .same(proto: "capacity"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularStringField(value: &self.name) }()
+      case 2: try { try decoder.decodeSingularUInt64Field(value: &self.hits) }()
+      case 3: try { try decoder.decodeSingularUInt64Field(value: &self.misses) }()
+      case 4: try { try decoder.decodeSingularUInt64Field(value: &self.evictions) }()
+      case 5: try { try decoder.decodeSingularUInt64Field(value: &self.invalidations) }()
+      case 6: try { try decoder.decodeSingularUInt32Field(value: &self.size) }()
+      case 7: try { try decoder.decodeSingularUInt32Field(value: &self.capacity) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if !self.name.isEmpty {
+      try visitor.visitSingularStringField(value: self.name, fieldNumber: 1)
+    }
+    if self.hits != 0 {
+      try visitor.visitSingularUInt64Field(value: self.hits, fieldNumber: 2)
+    }
+    if self.misses != 0 {
+      try visitor.visitSingularUInt64Field(value: self.misses, fieldNumber: 3)
+    }
+    if self.evictions != 0 {
+      try visitor.visitSingularUInt64Field(value: self.evictions, fieldNumber: 4)
+    }
+    if self.invalidations != 0 {
+      try visitor.visitSingularUInt64Field(value: self.invalidations, fieldNumber: 5)
+    }
+    if self.size != 0 {
+      try visitor.visitSingularUInt32Field(value: self.size, fieldNumber: 6)
+    }
+    if self.capacity != 0 {
+      try visitor.visitSingularUInt32Field(value: self.capacity, fieldNumber: 7)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_CacheStats, rhs: Hazkey_Stats_CacheStats) -> Bool {
+    if lhs.name != rhs.name {return false}
+    if lhs.hits != rhs.hits {return false}
+    if lhs.misses != rhs.misses {return false}
+    if lhs.evictions != rhs.evictions {return false}
+    if lhs.invalidations != rhs.invalidations {return false}
+    if lhs.size != rhs.size {return false}
+    if lhs.capacity != rhs.capacity {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Stats_ZenzaiStats: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".ZenzaiStats"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .standard(proto: "model_available"),
+    2: .same(proto: "enabled"),
+    3: .standard(proto: "model_path"),
+    4: .standard(proto: "backend_device"),
+    5: .standard(proto: "latency_target_ms"),
+    6: .standard(proto: "max_inference_limit"),
+    7: .standard(proto: "current_inference_limit"),
+    8: .standard(proto: "skips_suggest"),
+    9: .standard(proto: "skipped_suggests"),
+    10: .standard(proto: "limit_adjustments"),
+    11: .standard(proto: "p50_latency_us"),
+    12: .standard(proto: "p95_latency_us"),
+  ]
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    while let fieldNumber = try decoder.nextFieldNumber() {
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every case branch when no optimizations are
+      // enabled. https://github.com/apple/swift-protobuf/issues/1034
+      switch fieldNumber {
+      case 1: try { try decoder.decodeSingularBoolField(value: &self.modelAvailable) }()
+      case 2: try { try decoder.decodeSingularBoolField(value: &self.enabled) }()
+      case 3: try { try decoder.decodeSingularStringField(value: &self.modelPath) }()
+      case 4: try { try decoder.decodeSingularStringField(value: &self.backendDevice) }()
+      case 5: try { try decoder.decodeSingularInt32Field(value: &self.latencyTargetMs) }()
+      case 6: try { try decoder.decodeSingularInt32Field(value: &self.maxInferenceLimit) }()
+      case 7: try { try decoder.decodeSingularInt32Field(value: &self.currentInferenceLimit) }()
+      case 8: try { try decoder.decodeSingularBoolField(value: &self.skipsSuggest) }()
+      case 9: try { try decoder.decodeSingularUInt64Field(value: &self.skippedSuggests) }()
+      case 10: try { try decoder.decodeSingularUInt64Field(value: &self.limitAdjustments) }()
+      case 11: try { try decoder.decodeSingularUInt64Field(value: &self.p50LatencyUs) }()
+      case 12: try { try decoder.decodeSingularUInt64Field(value: &self.p95LatencyUs) }()
+      default: break
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    if self.modelAvailable != false {
+      try visitor.visitSingularBoolField(value: self.modelAvailable, fieldNumber: 1)
+    }
+    if self.enabled != false {
+      try visitor.visitSingularBoolField(value: self.enabled, fieldNumber: 2)
+    }
+    if !self.modelPath.isEmpty {
+      try visitor.visitSingularStringField(value: self.modelPath, fieldNumber: 3)
+    }
+    if !self.backendDevice.isEmpty {
+      try visitor.visitSingularStringField(value: self.backendDevice, fieldNumber: 4)
+    }
+    if self.latencyTargetMs != 0 {
+      try visitor.visitSingularInt32Field(value: self.latencyTargetMs, fieldNumber: 5)
+    }
+    if self.maxInferenceLimit != 0 {
+      try visitor.visitSingularInt32Field(value: self.maxInferenceLimit, fieldNumber: 6)
+    }
+    if self.currentInferenceLimit != 0 {
+      try visitor.visitSingularInt32Field(value: self.currentInferenceLimit, fieldNumber: 7)
+    }
+    if self.skipsSuggest != false {
+      try visitor.visitSingularBoolField(value: self.skipsSuggest, fieldNumber: 8)
+    }
+    if self.skippedSuggests != 0 {
+      try visitor.visitSingularUInt64Field(value: self.skippedSuggests, fieldNumber: 9)
+    }
+    if self.limitAdjustments != 0 {
+      try visitor.visitSingularUInt64Field(value: self.limitAdjustments, fieldNumber: 10)
+    }
+    if self.p50LatencyUs != 0 {
+      try visitor.visitSingularUInt64Field(value: self.p50LatencyUs, fieldNumber: 11)
+    }
+    if self.p95LatencyUs != 0 {
+      try visitor.visitSingularUInt64Field(value: self.p95LatencyUs, fieldNumber: 12)
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_ZenzaiStats, rhs: Hazkey_Stats_ZenzaiStats) -> Bool {
+    if lhs.modelAvailable != rhs.modelAvailable {return false}
+    if lhs.enabled != rhs.enabled {return false}
+    if lhs.modelPath != rhs.modelPath {return false}
+    if lhs.backendDevice != rhs.backendDevice {return false}
+    if lhs.latencyTargetMs != rhs.latencyTargetMs {return false}
+    if lhs.maxInferenceLimit != rhs.maxInferenceLimit {return false}
+    if lhs.currentInferenceLimit != rhs.currentInferenceLimit {return false}
+    if lhs.skipsSuggest != rhs.skipsSuggest {return false}
+    if lhs.skippedSuggests != rhs.skippedSuggests {return false}
+    if lhs.limitAdjustments != rhs.limitAdjustments {return false}
+    if lhs.p50LatencyUs != rhs.p50LatencyUs {return false}
+    if lhs.p95LatencyUs != rhs.p95LatencyUs {return false}
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
+
+extension Hazkey_Stats_ServerStats: SwiftProtobuf.Message, SwiftProtobuf._MessageImplementationBase, SwiftProtobuf._ProtoNameProviding {
+  static let protoMessageName: String = _protobuf_package + ".ServerStats"
+  static let _protobuf_nameMap: SwiftProtobuf._NameMap = [
+    1: .same(proto: "version"),
+    2: .standard(proto: "uptime_ms"),
+    3: .standard(proto: "rss_bytes"),
+    4: .standard(proto: "active_profile_id"),
+    5: .same(proto: "requests"),
+    6: .standard(proto: "dictionary_conversion"),
+    7: .standard(proto: "zenzai_conversion"),
+    8: .standard(proto: "learning_save"),
+    9: .same(proto: "caches"),
+    10: .same(proto: "zenzai"),
+    11: .standard(proto: "client_connections"),
+    12: .standard(proto: "socket_backlog_bytes"),
+    13: .standard(proto: "max_socket_backlog_bytes"),
+  ]
+
+  fileprivate class _StorageClass {
+    var _version: String = String()
+    var _uptimeMs: UInt64 = 0
+    var _rssBytes: UInt64 = 0
+    var _activeProfileID: String = String()
+    var _requests: [Hazkey_Stats_RequestStats] = []
+    var _dictionaryConversion: Hazkey_Stats_Histogram? = nil
+    var _zenzaiConversion: Hazkey_Stats_Histogram? = nil
+    var _learningSave: Hazkey_Stats_Histogram? = nil
+    var _caches: [Hazkey_Stats_CacheStats] = []
+    var _zenzai: Hazkey_Stats_ZenzaiStats? = nil
+    var _clientConnections: UInt64 = 0
+    var _socketBacklogBytes: UInt64 = 0
+    var _maxSocketBacklogBytes: UInt64 = 0
+
+      // This property is used as the initial default value for new instances of the type.
+      // The type itself is protecting the reference to its storage via CoW semantics.
+      // This will force a copy to be made of this reference when the first mutation occurs;
+      // hence, it is safe to mark this as `nonisolated(unsafe)`.
+      static nonisolated(unsafe) let defaultInstance = _StorageClass()
+
+    private init() {}
+
+    init(copying source: _StorageClass) {
+      _version = source._version
+      _uptimeMs = source._uptimeMs
+      _rssBytes = source._rssBytes
+      _activeProfileID = source._activeProfileID
+      _requests = source._requests
+      _dictionaryConversion = source._dictionaryConversion
+      _zenzaiConversion = source._zenzaiConversion
+      _learningSave = source._learningSave
+      _caches = source._caches
+      _zenzai = source._zenzai
+      _clientConnections = source._clientConnections
+      _socketBacklogBytes = source._socketBacklogBytes
+      _maxSocketBacklogBytes = source._maxSocketBacklogBytes
+    }
+  }
+
+  fileprivate mutating func _uniqueStorage() -> _StorageClass {
+    if !isKnownUniquelyReferenced(&_storage) {
+      _storage = _StorageClass(copying: _storage)
+    }
+    return _storage
+  }
+
+  mutating func decodeMessage<D: SwiftProtobuf.Decoder>(decoder: inout D) throws {
+    _ = _uniqueStorage()
+    try withExtendedLifetime(_storage) { (_storage: _StorageClass) in
+      while let fieldNumber = try decoder.nextFieldNumber() {
+        // The use of inline closures is to circumvent an issue where the compiler
+        // allocates stack space for every case branch when no optimizations are
+        // enabled. https://github.com/apple/swift-protobuf/issues/1034
+        switch fieldNumber {
+        case 1: try { try decoder.decodeSingularStringField(value: &_storage._version) }()
+        case 2: try { try decoder.decodeSingularUInt64Field(value: &_storage._uptimeMs) }()
+        case 3: try { try decoder.decodeSingularUInt64Field(value: &_storage._rssBytes) }()
+        case 4: try { try decoder.decodeSingularStringField(value: &_storage._activeProfileID) }()
+        case 5: try { try decoder.decodeRepeatedMessageField(value: &_storage._requests) }()
+        case 6: try { try decoder.decodeSingularMessageField(value: &_storage._dictionaryConversion) }()
+        case 7: try { try decoder.decodeSingularMessageField(value: &_storage._zenzaiConversion) }()
+        case 8: try { try decoder.decodeSingularMessageField(value: &_storage._learningSave) }()
+        case 9: try { try decoder.decodeRepeatedMessageField(value: &_storage._caches) }()
+        case 10: try { try decoder.decodeSingularMessageField(value: &_storage._zenzai) }()
+        case 11: try { try decoder.decodeSingularUInt64Field(value: &_storage._clientConnections) }()
+        case 12: try { try decoder.decodeSingularUInt64Field(value: &_storage._socketBacklogBytes) }()
+        case 13: try { try decoder.decodeSingularUInt64Field(value: &_storage._maxSocketBacklogBytes) }()
+        default: break
+        }
+      }
+    }
+  }
+
+  func traverse<V: SwiftProtobuf.Visitor>(visitor: inout V) throws {
+    try withExtendedLifetime(_storage) { (_storage: _StorageClass) in
+      // The use of inline closures is to circumvent an issue where the compiler
+      // allocates stack space for every if/case branch local when no optimizations
+      // are enabled. https://github.com/apple/swift-protobuf/issues/1034 and
+      // https://github.com/apple/swift-protobuf/issues/1182
+      if !_storage._version.isEmpty {
+        try visitor.visitSingularStringField(value: _storage._version, fieldNumber: 1)
+      }
+      if _storage._uptimeMs != 0 {
+        try visitor.visitSingularUInt64Field(value: _storage._uptimeMs, fieldNumber: 2)
+      }
+      if _storage._rssBytes != 0 {
+        try visitor.visitSingularUInt64Field(value: _storage._rssBytes, fieldNumber: 3)
+      }
+      if !_storage._activeProfileID.isEmpty {
+        try visitor.visitSingularStringField(value: _storage._activeProfileID, fieldNumber: 4)
+      }
+      if !_storage._requests.isEmpty {
+        try visitor.visitRepeatedMessageField(value: _storage._requests, fieldNumber: 5)
+      }
+      try { if let v = _storage._dictionaryConversion {
+        try visitor.visitSingularMessageField(value: v, fieldNumber: 6)
+      } }()
+      try { if let v = _storage._zenzaiConversion {
+        try visitor.visitSingularMessageField(value: v, fieldNumber: 7)
+      } }()
+      try { if let v = _storage._learningSave {
+        try visitor.visitSingularMessageField(value: v, fieldNumber: 8)
+      } }()
+      if !_storage._caches.isEmpty {
+        try visitor.visitRepeatedMessageField(value: _storage._caches, fieldNumber: 9)
+      }
+      try { if let v = _storage._zenzai {
+        try visitor.visitSingularMessageField(value: v, fieldNumber: 10)
+      } }()
+      if _storage._clientConnections != 0 {
+        try visitor.visitSingularUInt64Field(value: _storage._clientConnections, fieldNumber: 11)
+      }
+      if _storage._socketBacklogBytes != 0 {
+        try visitor.visitSingularUInt64Field(value: _storage._socketBacklogBytes, fieldNumber: 12)
+      }
+      if _storage._maxSocketBacklogBytes != 0 {
+        try visitor.visitSingularUInt64Field(value: _storage._maxSocketBacklogBytes, fieldNumber: 13)
+      }
+    }
+    try unknownFields.traverse(visitor: &visitor)
+  }
+
+  static func ==(lhs: Hazkey_Stats_ServerStats, rhs: Hazkey_Stats_ServerStats) -> Bool {
+    if lhs._storage !== rhs._storage {
+      let storagesAreEqual: Bool = withExtendedLifetime((lhs._storage, rhs._storage)) { (_args: (_StorageClass, _StorageClass)) in
+        let _storage = _args.0
+        let rhs_storage = _args.1
+        if _storage._version != rhs_storage._version {return false}
+        if _storage._uptimeMs != rhs_storage._uptimeMs {return false}
+        if _storage._rssBytes != rhs_storage._rssBytes {return false}
+        if _storage._activeProfileID != rhs_storage._activeProfileID {return false}
+        if _storage._requests != rhs_storage._requests {return false}
+        if _storage._dictionaryConversion != rhs_storage._dictionaryConversion {return false}
+        if _storage._zenzaiConversion != rhs_storage._zenzaiConversion {return false}
+        if _storage._learningSave != rhs_storage._learningSave {return false}
+        if _storage._caches != rhs_storage._caches {return false}
+        if _storage._zenzai != rhs_storage._zenzai {return false}
+        if _storage._clientConnections != rhs_storage._clientConnections {return false}
+        if _storage._socketBacklogBytes != rhs_storage._socketBacklogBytes {return false}
+        if _storage._maxSocketBacklogBytes != rhs_storage._maxSocketBacklogBytes {return false}
+        return true
+      }
+      if !storagesAreEqual {return false}
+    }
+    if lhs.unknownFields != rhs.unknownFields {return false}
+    return true
+  }
+}
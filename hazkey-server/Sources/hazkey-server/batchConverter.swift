@@ -0,0 +1,76 @@
+import Foundation
+import KanaKanjiConverterModule
+
+/// Converts many readings in parallel for ConvertBatch.
+/// Every worker owns a KanaKanjiConverter, so no lattice or cache is shared
+/// between threads and the interactive converter is left untouched.
+final class BatchConverter {
+    private let dictionaryURL: URL
+    // created on first use and kept for later batches
+    private var converters: [KanaKanjiConverter] = []
+
+    init(dictionaryURL: URL) {
+        self.dictionaryURL = dictionaryURL
+    }
+
+    /// zenzaiMode maps a left context to the Zenzai mode, nil for dictionary
+    /// only conversion. With Zenzai, each converter would load its own copy of
+    /// the model, so those batches run on a single worker.
+    func convert(
+        items: [Hazkey_Commands_ConvertBatch.Item],
+        baseOptions: ConvertRequestOptions,
+        nBest: Int,
+        zenzaiMode: ((String) -> ConvertRequestOptions.ZenzaiMode)?
+    ) -> [Hazkey_Commands_ConvertBatchResult.Item] {
+        guard !items.isEmpty else { return [] }
+
+        let workerCount =
+            zenzaiMode != nil
+            ? 1 : min(ProcessInfo.processInfo.activeProcessorCount, items.count)
+        while converters.count < workerCount {
+            converters.append(KanaKanjiConverter(dictionaryURL: dictionaryURL))
+        }
+
+        var options = baseOptions
+        options.N_best = nBest
+        // batch results must not depend on or change the user's history
+        options.learningType = .nothing
+
+        // resolved on this thread because zenzaiMode reads the server config
+        let zenzaiModes = items.map { zenzaiMode?($0.leftContext) ?? .off }
+
+        var results = [Hazkey_Commands_ConvertBatchResult.Item](
+            repeating: Hazkey_Commands_ConvertBatchResult.Item(), count: items.count)
+        let nextIndexLock = NSLock()
+        var nextIndex = 0
+
+        results.withUnsafeMutableBufferPointer { resultBuffer in
+            DispatchQueue.concurrentPerform(iterations: workerCount) { worker in
+                let converter = converters[worker]
+                while true {
+                    nextIndexLock.lock()
+                    let index = nextIndex
+                    nextIndex += 1
+                    nextIndexLock.unlock()
+                    guard index < items.count else { break }
+
+                    var composingText = ComposingText()
+                    composingText.insertAtCursorPosition(
+                        items[index].reading, inputStyle: .direct)
+                    var itemOptions = options
+                    itemOptions.zenzaiMode = zenzaiModes[index]
+
+                    let converted = converter.requestCandidates(
+                        composingText, options: itemOptions)
+                    // readings are unrelated, so do not reuse the lattice
+                    converter.stopComposition()
+
+                    resultBuffer[index] = Hazkey_Commands_ConvertBatchResult.Item.with {
+                        $0.candidates = converted.mainResults.prefix(nBest).map { $0.text }
+                    }
+                }
+            }
+        }
+        return results
+    }
+}
@@ -213,6 +213,8 @@ class HazkeyServerConfig {
         newConf.useRichSuggestion = false
         newConf.numCandidatesPerPage = 9
         newConf.useRichCandidates = false
+        // off until a speculative conversion can be interrupted by a key
+        newConf.speculativeConversionDelayMs = 0
         newConf.useInputHistory = true
         newConf.specialConversionMode = Hazkey_Config_Profile.SpecialConversionMode.with {
             $0.commaSeparatedNumber = true
@@ -292,13 +294,23 @@ class HazkeyServerConfig {
         NSLog("Config saved to: \(configPath.path)")
 
         profiles = newProfiles
-        currentProfile = profiles[0]
+        // keep the activated profile if it still exists
+        currentProfile =
+            profiles.first { $0.profileID == currentProfile.profileID } ?? profiles[0]
 
         if let state = state {
             state.reinitializeConfiguration()
         }
     }
 
+    func selectProfile(profileID: String) -> Bool {
+        guard let profile = profiles.first(where: { $0.profileID == profileID }) else {
+            return false
+        }
+        currentProfile = profile
+        return true
+    }
+
     static func loadConfig() throws -> [Hazkey_Config_Profile] {
         let configDir = Self.getConfigDirectory()
         let configPath = configDir.appendingPathComponent("config.json")
@@ -385,7 +397,11 @@ class HazkeyServerConfig {
         return homeDir.appendingPathComponent(".cache").appendingPathComponent("hazkey")
     }
 
-    func genZenzaiMode(leftContext: String)
+    var isZenzaiEnabled: Bool {
+        return zenzaiAvailable && zenzaiModelPath != nil && currentProfile.zenzaiEnable
+    }
+
+    func genZenzaiMode(leftContext: String, inferenceLimit: Int? = nil)
         -> ConvertRequestOptions.ZenzaiMode
     {
         let deviceName =
@@ -395,7 +411,7 @@ class HazkeyServerConfig {
         if zenzaiAvailable, let zenzaiModelPath = zenzaiModelPath, currentProfile.zenzaiEnable {
             return ConvertRequestOptions.ZenzaiMode.on(
                 weight: zenzaiModelPath,
-                inferenceLimit: Int(currentProfile.zenzaiInferLimit),
+                inferenceLimit: inferenceLimit ?? Int(currentProfile.zenzaiInferLimit),
                 requestRichCandidates: currentProfile.useRichCandidates,
                 personalizationMode: nil,
                 versionDependentMode: .v3(
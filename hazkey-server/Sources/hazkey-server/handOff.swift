@@ -0,0 +1,186 @@
+import Foundation
+
+/// Live hand-off from a running hazkey-server to its replacement.
+///
+/// The replacement listens on a side socket and sends SIGUSR1 to the running
+/// server. The running server stops serving, commits learning data, then sends
+/// its session state along with its listening socket and connected client
+/// (SCM_RIGHTS) and exits without unlinking the main socket. Requests the
+/// client sends in between wait in the socket buffer instead of failing.
+enum HandOff {
+    static let signal = SIGUSR1
+    // how long the replacement waits for the running server
+    static let timeoutMs: Int32 = 2000
+
+    struct Received {
+        let message: Hazkey_Handoff_HandOff
+        let serverFd: Int32
+        let clientFd: Int32?
+    }
+
+    private static let maxMessageSize: UInt32 = 1024 * 1024
+
+    private static func controlAlign(_ length: Int) -> Int {
+        let alignment = MemoryLayout<Int>.size
+        return (length + alignment - 1) & ~(alignment - 1)
+    }
+
+    private static let controlHeaderLength = controlAlign(MemoryLayout<cmsghdr>.size)
+    // listening socket and client
+    private static let controlLength =
+        controlHeaderLength + controlAlign(2 * MemoryLayout<Int32>.size)
+
+    /// Called by the replacement. Returns nil if the running server did not
+    /// hand off in time; the caller then falls back to terminating it.
+    static func receive(path: String, from pid: pid_t) -> Received? {
+        let listenFd: Int32
+        do {
+            listenFd = try listenUnixSocket(path: path, backlog: 1)
+        } catch {
+            NSLog("Failed to set up hand-off socket: \(error)")
+            return nil
+        }
+        defer {
+            close(listenFd)
+            unlink(path)
+        }
+
+        guard kill(pid, signal) == 0 else {
+            NSLog("Failed to request hand-off from PID \(pid): errno \(errno)")
+            return nil
+        }
+
+        var pollFd = pollfd(fd: listenFd, events: Int16(POLLIN), revents: 0)
+        guard poll(&pollFd, 1, timeoutMs) > 0 else {
+            NSLog("Hand-off from PID \(pid) timed out")
+            return nil
+        }
+
+        let connFd = accept(listenFd, nil, nil)
+        guard connFd != -1 else {
+            NSLog("Failed to accept hand-off connection: errno \(errno)")
+            return nil
+        }
+        defer { close(connFd) }
+
+        // descriptors arrive attached to the length header
+        var lengthBuf: UInt32 = 0
+        var control = [UInt8](repeating: 0, count: controlLength)
+        let headerRead = withUnsafeMutableBytes(of: &lengthBuf) { lengthBytes in
+            control.withUnsafeMutableBytes { controlBytes in
+                var iov = iovec(iov_base: lengthBytes.baseAddress, iov_len: lengthBytes.count)
+                return withUnsafeMutablePointer(to: &iov) { iovPtr in
+                    var msg = msghdr()
+                    msg.msg_iov = iovPtr
+                    msg.msg_iovlen = 1
+                    msg.msg_control = controlBytes.baseAddress
+                    msg.msg_controllen = controlBytes.count
+                    return recvmsg(connFd, &msg, Int32(MSG_WAITALL))
+                }
+            }
+        }
+        guard headerRead == 4 else {
+            NSLog("Failed to read hand-off header: errno \(errno)")
+            return nil
+        }
+
+        let fds: [Int32] = control.withUnsafeBytes { controlBytes in
+            let header = controlBytes.load(as: cmsghdr.self)
+            guard header.cmsg_level == SOL_SOCKET, header.cmsg_type == Int32(SCM_RIGHTS)
+            else { return [] }
+            let count = (Int(header.cmsg_len) - controlHeaderLength) / MemoryLayout<Int32>.size
+            return (0..<count).map {
+                controlBytes.load(
+                    fromByteOffset: controlHeaderLength + $0 * MemoryLayout<Int32>.size,
+                    as: Int32.self)
+            }
+        }
+        guard let serverFd = fds.first else {
+            NSLog("Hand-off did not include the listening socket")
+            return nil
+        }
+
+        let length = lengthBuf.bigEndian
+        let message: Hazkey_Handoff_HandOff
+        do {
+            guard length <= maxMessageSize else {
+                throw SocketError.messageTooLarge(length)
+            }
+            let body = try readData(from: connFd, count: Int(length))
+            message = try Hazkey_Handoff_HandOff(serializedBytes: body)
+        } catch {
+            NSLog("Failed to read hand-off state: \(error)")
+            fds.forEach { close($0) }
+            return nil
+        }
+
+        return Received(
+            message: message,
+            serverFd: serverFd,
+            clientFd: message.clientAttached && fds.count > 1 ? fds[1] : nil)
+    }
+
+    /// Called by the running server after it has stopped serving.
+    static func send(
+        path: String, message: Hazkey_Handoff_HandOff, serverFd: Int32, clientFd: Int32?
+    ) -> Bool {
+        let body: Data
+        do {
+            body = try message.serializedData()
+        } catch {
+            NSLog("Failed to serialize hand-off state: \(error)")
+            return false
+        }
+
+        let connFd = connectUnixSocket(path: path)
+        guard connFd != -1 else {
+            NSLog("No replacement server is waiting for the hand-off")
+            return false
+        }
+        defer { close(connFd) }
+
+        let fds = clientFd.map { [serverFd, $0] } ?? [serverFd]
+        var control = [UInt8](repeating: 0, count: controlLength)
+        let usedControlLength =
+            controlHeaderLength + controlAlign(fds.count * MemoryLayout<Int32>.size)
+        control.withUnsafeMutableBytes { controlBytes in
+            var header = cmsghdr()
+            header.cmsg_len = controlHeaderLength + fds.count * MemoryLayout<Int32>.size
+            header.cmsg_level = SOL_SOCKET
+            header.cmsg_type = Int32(SCM_RIGHTS)
+            controlBytes.storeBytes(of: header, as: cmsghdr.self)
+            for (i, fd) in fds.enumerated() {
+                controlBytes.storeBytes(
+                    of: fd, toByteOffset: controlHeaderLength + i * MemoryLayout<Int32>.size,
+                    as: Int32.self)
+            }
+        }
+
+        var lengthBuf = UInt32(body.count).bigEndian
+        let headerSent = withUnsafeMutableBytes(of: &lengthBuf) { lengthBytes in
+            control.withUnsafeMutableBytes { controlBytes in
+                var iov = iovec(iov_base: lengthBytes.baseAddress, iov_len: lengthBytes.count)
+                return withUnsafeMutablePointer(to: &iov) { iovPtr in
+                    var msg = msghdr()
+                    msg.msg_iov = iovPtr
+                    msg.msg_iovlen = 1
+                    msg.msg_control = controlBytes.baseAddress
+                    msg.msg_controllen = usedControlLength
+                    return sendmsg(connFd, &msg, 0)
+                }
+            }
+        }
+        guard headerSent == 4 else {
+            NSLog("Failed to send hand-off descriptors: errno \(errno)")
+            return false
+        }
+
+        do {
+            try writeData(to: connFd, data: body)
+        } catch {
+            NSLog("Failed to send hand-off state: \(error)")
+            return false
+        }
+        return true
+    }
+}
@@ -0,0 +1,129 @@
+import Foundation
+
+/// Bounded least-recently-used cache.
+final class LRUCache<Key: Hashable, Value> {
+    struct Statistics {
+        var capacity: Int
+        var count: Int
+        var hits: UInt64
+        var misses: UInt64
+        var evictions: UInt64
+        var invalidations: UInt64
+
+        var hitRate: Double {
+            let lookups = hits + misses
+            return lookups == 0 ? 0 : Double(hits) / Double(lookups)
+        }
+    }
+
+    private final class Node {
+        let key: Key
+        var value: Value
+        weak var prev: Node?
+        var next: Node?
+
+        init(key: Key, value: Value) {
+            self.key = key
+            self.value = value
+        }
+    }
+
+    let capacity: Int
+    private var nodes: [Key: Node] = [:]
+    // most recently used
+    private var head: Node?
+    // least recently used
+    private var tail: Node?
+
+    private var hits: UInt64 = 0
+    private var misses: UInt64 = 0
+    private var evictions: UInt64 = 0
+    private var invalidations: UInt64 = 0
+
+    init(capacity: Int) {
+        self.capacity = max(capacity, 1)
+        nodes.reserveCapacity(self.capacity)
+    }
+
+    var count: Int {
+        return nodes.count
+    }
+
+    func value(forKey key: Key) -> Value? {
+        guard let node = nodes[key] else {
+            misses += 1
+            return nil
+        }
+        hits += 1
+        moveToHead(node)
+        return node.value
+    }
+
+    func setValue(_ value: Value, forKey key: Key) {
+        if let node = nodes[key] {
+            node.value = value
+            moveToHead(node)
+            return
+        }
+
+        let node = Node(key: key, value: value)
+        nodes[key] = node
+        insertAtHead(node)
+
+        if nodes.count > capacity, let lru = tail {
+            unlink(lru)
+            nodes[lru.key] = nil
+            evictions += 1
+        }
+    }
+
+    func removeAll() {
+        guard !nodes.isEmpty else { return }
+        nodes.removeAll(keepingCapacity: true)
+        head = nil
+        tail = nil
+        invalidations += 1
+    }
+
+    func statistics() -> Statistics {
+        return Statistics(
+            capacity: capacity,
+            count: nodes.count,
+            hits: hits,
+            misses: misses,
+            evictions: evictions,
+            invalidations: invalidations
+        )
+    }
+
+    private func moveToHead(_ node: Node) {
+        guard head !== node else { return }
+        unlink(node)
+        insertAtHead(node)
+    }
+
+    private func insertAtHead(_ node: Node) {
+        node.prev = nil
+        node.next = head
+        head?.prev = node
+        head = node
+        if tail == nil {
+            tail = node
+        }
+    }
+
+    private func unlink(_ node: Node) {
+        if let prev = node.prev {
+            prev.next = node.next
+        } else {
+            head = node.next
+        }
+        if let next = node.next {
+            next.prev = node.prev
+        } else {
+            tail = node.prev
+        }
+        node.prev = nil
+        node.next = nil
+    }
+}
@@ -14,16 +14,22 @@ enum ProcessManagerError: Error {
     case lockCreationFailed
     case anotherInstanceRunning
     case terminationFailed
+    case procScanFailed(Int32)
 }
 
 class ProcessManager {
+    // upper bounds for waiting on a server being replaced
+    private static let termTimeoutMs: Int32 = 1500
+    private static let killTimeoutMs: Int32 = 500
+
+    // effective uid, which is what owns /proc/<pid> and what pgrep -u matches
     private let uid: uid_t
     private let pid: pid_t
     private let lockFilePath: String
     private var lockFd: Int32 = -1
 
     init(lockFilePath: String) {
-        self.uid = getuid()
+        self.uid = geteuid()
         self.pid = getpid()
         self.lockFilePath = lockFilePath
     }
@@ -34,7 +40,10 @@ class ProcessManager {
         }
     }
 
-    func tryLock(force: Bool) throws {
+    /// handOff is called with the PID of a running server that supports live
+    /// hand-off before falling back to terminating it. It returns true once
+    /// the running server has handed over its socket and is exiting.
+    func tryLock(force: Bool, handOff: (pid_t) -> Bool = { _ in false }) throws {
         // parent directory is created by HazkeyServer.start()
 
         // try lock
@@ -46,20 +55,27 @@ class ProcessManager {
 
         if flock(lockFd, LOCK_EX | LOCK_NB) != 0 {
             // lock fail
-            if let (oldPid, versionMatch) = readLockFile() {
-                if !force, versionMatch {
+            if let lockInfo = readLockFile() {
+                let oldPid = lockInfo.pid
+                if !force, lockInfo.versionMatch {
                     NSLog("Another hazkey-server is already running.")
                     NSLog("Use -r or --replace option to replace the existing server.")
                     throw ProcessManagerError.anotherInstanceRunning
                 }
 
-                if !versionMatch {
-                    NSLog("Version mismatch detected. Terminating old server...")
+                if !lockInfo.versionMatch {
+                    NSLog("Version mismatch detected. Replacing old server...")
                 }
 
-                // terminate process
                 if kill(oldPid, 0) == 0 {
-                    try terminateAnotherServer(pid: oldPid)
+                    if lockInfo.supportsHandOff, handOff(oldPid) {
+                        // the old server exits on its own after handing off
+                        if !waitForExit(pid: oldPid, timeoutMs: Self.termTimeoutMs) {
+                            try terminateAnotherServer(pid: oldPid)
+                        }
+                    } else {
+                        try terminateAnotherServer(pid: oldPid)
+                    }
                 }
             } else {
                 // broken lockfile
@@ -80,7 +96,13 @@ class ProcessManager {
         writeLockFile()
     }
 
-    private func readLockFile() -> (Int32, Bool)? {
+    private struct LockInfo {
+        let pid: pid_t
+        let versionMatch: Bool
+        let supportsHandOff: Bool
+    }
+
+    private func readLockFile() -> LockInfo? {
         let capacity = 256
         lseek(lockFd, 0, SEEK_SET)
         let buffer = UnsafeMutablePointer<Int8>.allocate(capacity: capacity)
@@ -94,8 +116,10 @@ class ProcessManager {
             .map { $0.trimmingCharacters(in: .whitespaces) }
         guard lines.count >= 2 else { return nil }
         let versionMatch = lines[1] == hazkeyVersion
+        // servers that predate hand-off only write two lines
+        let supportsHandOff = lines.count >= 3 && lines[2] == "handoff"
         guard let pid = Int32(lines[0]) else { return nil }
-        return (pid, versionMatch)
+        return LockInfo(pid: pid, versionMatch: versionMatch, supportsHandOff: supportsHandOff)
     }
 
     private func writeLockFile() {
@@ -104,7 +128,7 @@ class ProcessManager {
             return
         }
         lseek(lockFd, 0, SEEK_SET)
-        let info = "\(getpid())\n\(hazkeyVersion)\n"
+        let info = "\(getpid())\n\(hazkeyVersion)\nhandoff\n"
         let written = write(lockFd, info, info.utf8.count)
         if written != info.utf8.count {
             NSLog("Failed to write complete lock file data")
@@ -112,55 +136,104 @@ class ProcessManager {
         fsync(lockFd)
     }
 
+    /// Other hazkey-server processes of this user, found by scanning /proc
+    /// the same way `pgrep -u <uid> -x hazkey-server` does.
     private func getOtherServerPIDs() throws -> [Int32] {
-        let task = Process()
-        task.executableURL = URL(fileURLWithPath: "/usr/bin/env")
-        task.arguments = ["pgrep", "-u", String(uid), "-x", "hazkey-server"]
-        let pipe = Pipe()
-        task.standardOutput = pipe
+        guard let procDir = opendir("/proc") else {
+            throw ProcessManagerError.procScanFailed(errno)
+        }
+        defer { closedir(procDir) }
 
-        try task.run()
-        let data = pipe.fileHandleForReading.readDataToEndOfFile()
-        task.waitUntilExit()
+        var pids: [Int32] = []
+        while let entry = readdir(procDir) {
+            let name = withUnsafePointer(to: &entry.pointee.d_name) {
+                String(cString: UnsafeRawPointer($0).assumingMemoryBound(to: CChar.self))
+            }
+            guard let entryPid = Int32(name), entryPid != pid else { continue }
 
-        guard let output = String(data: data, encoding: .utf8) else { return [] }
+            // the /proc/<pid> directory is owned by the process's effective uid
+            var info = stat()
+            guard stat("/proc/\(name)", &info) == 0, info.st_uid == uid else { continue }
 
-        let pidString = String(pid)
+            guard
+                let comm = try? String(contentsOfFile: "/proc/\(name)/comm", encoding: .utf8),
+                comm.trimmingCharacters(in: .newlines) == "hazkey-server"
+            else { continue }
+            pids.append(entryPid)
+        }
+        return pids
+    }
 
-        return output.components(separatedBy: .newlines)
-            .compactMap { $0.trimmingCharacters(in: .whitespaces) }
-            .filter { !$0.isEmpty && $0 != pidString }
-            .compactMap { Int32($0) }
+    /// Waits until pid exits or timeoutMs passes. Returns true if it exited.
+    /// Uses a pidfd, which becomes readable when the process exits, and falls
+    /// back to polling on kernels and libcs without pidfd_open().
+    private func waitForExit(pid: pid_t, timeoutMs: Int32) -> Bool {
+        let pidfd = Self.openPidfd(pid)
+        if pidfd == -1 {
+            if errno == ESRCH {
+                return true
+            }
+            return pollForExit(pid: pid, timeoutMs: timeoutMs)
+        }
+        defer { close(pidfd) }
+
+        var pollFd = pollfd(fd: pidfd, events: Int16(POLLIN), revents: 0)
+        let deadline = DispatchTime.now().uptimeNanoseconds + UInt64(timeoutMs) * 1_000_000
+        while true {
+            let now = DispatchTime.now().uptimeNanoseconds
+            guard now < deadline else { return false }
+            let res = poll(&pollFd, 1, Int32((deadline - now) / 1_000_000) + 1)
+            if res > 0 {
+                return true
+            }
+            if res == 0 || errno != EINTR {
+                return false
+            }
+        }
+    }
+
+    private func pollForExit(pid: pid_t, timeoutMs: Int32) -> Bool {
+        let intervalMs: Int32 = 10
+        for _ in 0..<(timeoutMs / intervalMs) {
+            if kill(pid, 0) != 0 {
+                return true
+            }
+            usleep(UInt32(intervalMs) * 1_000)
+        }
+        return kill(pid, 0) != 0
+    }
+
+    private typealias PidfdOpen = @convention(c) (pid_t, UInt32) -> Int32
+
+    /// pidfd_open() is a glibc 2.36+ wrapper and syscall() is variadic, so
+    /// it is looked up at runtime. Returns -1 with errno set on failure.
+    private static func openPidfd(_ pid: pid_t) -> Int32 {
+        guard let libc = dlopen(nil, RTLD_NOW), let symbol = dlsym(libc, "pidfd_open") else {
+            errno = ENOSYS
+            return -1
+        }
+        let pidfdOpen = unsafeBitCast(symbol, to: PidfdOpen.self)
+        return pidfdOpen(pid, 0)
     }
 
     private func terminateAnotherServer(pid: pid_t) throws {
         NSLog("Terminating existing server with PID \(pid)...")
+        let start = DispatchTime.now()
 
         // Send SIGTERM to gracefully terminate
         if kill(pid, SIGTERM) != 0 { return }
 
-        for attempt in 1...30 {  // 30 try * 0.1 sec
-            usleep(100_000)  // 0.1 sec
-
-            // Check if process is still running
-            if kill(pid, 0) != 0 {
-                NSLog("Existing server terminated successfully")
-                return
-            }
-
-            if attempt == 15 {  // try SIGKILL
-                NSLog("Server didn't respond to SIGTERM, sending SIGKILL...")
-                kill(pid, SIGKILL)
+        if !waitForExit(pid: pid, timeoutMs: Self.termTimeoutMs) {
+            NSLog("Server didn't respond to SIGTERM, sending SIGKILL...")
+            kill(pid, SIGKILL)
+            if !waitForExit(pid: pid, timeoutMs: Self.killTimeoutMs) {
+                NSLog("Failed to terminate existing server")
+                throw ProcessManagerError.terminationFailed
             }
         }
 
-        // Final check
-        if kill(pid, 0) == 0 {
-            NSLog("Failed to terminate existing server")
-            throw ProcessManagerError.terminationFailed
-        }
-
-        NSLog("Existing server terminated")
+        let elapsedMs = ServerStatsCollector.elapsedMicroseconds(since: start) / 1_000
+        NSLog("Existing server terminated in \(elapsedMs)ms")
     }
 
     private func terminateOtherServers() {
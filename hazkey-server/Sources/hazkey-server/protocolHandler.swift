@@ -9,6 +9,7 @@ class ProtocolHandler {
     }
 
     func processProto(data: Data) -> Data {
+        let traceStart = state.tracer.begin()
         let query: Hazkey_RequestEnvelope
         let response: Hazkey_ResponseEnvelope
 
@@ -23,10 +24,14 @@ class ProtocolHandler {
             return serializeResult(unserialized: response)
         }
 
+        state.tracer.currentTraceID = query.traceID
+        let requestStart = DispatchTime.now()
+        if query.hasInputModeState {
+            state.applyInputModeState(query.inputModeState)
+        }
         switch query.payload {
         case .setContext(let req):
-            response = state.setContext(
-                surroundingText: req.context, anchorIndex: Int(req.anchor))
+            response = state.setContext(req)
         case .newComposingText:
             response = state.createComposingTextInstanse()
         case .inputChar(let req):
@@ -47,11 +52,18 @@ class ProtocolHandler {
             response = state.getComposingString(
                 charType: req.charType, currentPreedit: req.currentPreedit)
         case .getCandidates(let req):
-            response = state.getCandidates(is_suggest: req.isSuggest)
+            response = state.getCandidates(
+                is_suggest: req.isSuggest,
+                deltaBaseVersion: req.deltaBaseVersion == 0 ? nil : req.deltaBaseVersion,
+                paged: req.paged)
+        case .getCandidatePage(let req):
+            response = state.getCandidatePage(req)
         case .getCurrentInputMode:
             response = state.getCurrentInputMode()
         case .saveLearningData:
             response = state.saveLearningData()
+        case .convertBatch(let req):
+            response = state.convertBatch(req)
         case .getConfig:
             response = state.serverConfig.getCurrentConfig()
         case .setConfig(let req):
@@ -64,6 +76,15 @@ class ProtocolHandler {
             response = Hazkey_ResponseEnvelope.with {
                 $0.status = .success
             }
+        case .activateProfile(let req):
+            response = state.activateProfile(profileID: req.profileID)
+        case .getStats(let req):
+            response = state.getStats(reset: req.reset)
+        case .flushTrace:
+            response = Hazkey_ResponseEnvelope.with {
+                $0.status = .success
+                $0.text = state.tracer.exportEvents()
+            }
         case .getDefaultProfile:
             NSLog("Unimplemented: getDefaultProfile")
             response = Hazkey_ResponseEnvelope.with {
@@ -77,7 +98,13 @@ class ProtocolHandler {
                 $0.errorMessage = "Payload not specified"
             }
         }
-        return serializeResult(unserialized: response)
+        state.stats.recordRequest(
+            payloadType: query.payload?.payloadType ?? "none",
+            elapsedUs: ServerStatsCollector.elapsedMicroseconds(since: requestStart),
+            succeeded: response.status == .success)
+        let serialized = serializeResult(unserialized: response)
+        state.tracer.end("ProtocolHandler.processProto", start: traceStart)
+        return serialized
     }
 
     private func serializeResult(unserialized: Hazkey_ResponseEnvelope) -> Data {
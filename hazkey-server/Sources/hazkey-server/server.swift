@@ -1,5 +1,29 @@
 import Foundation
 
+/// Logs how long each startup phase takes, up to accepting requests.
+private struct StartupTimer {
+    private let start = DispatchTime.now()
+    private var phaseStart = DispatchTime.now()
+    private var phases: [String] = []
+
+    private static func formatMs(from: DispatchTime, to: DispatchTime) -> String {
+        let ms = Double(to.uptimeNanoseconds - from.uptimeNanoseconds) / 1_000_000
+        return String(format: "%.1fms", ms)
+    }
+
+    mutating func finish(_ phase: String) {
+        let now = DispatchTime.now()
+        phases.append("\(phase) \(Self.formatMs(from: phaseStart, to: now))")
+        phaseStart = now
+    }
+
+    func log() {
+        NSLog(
+            "Startup: \(phases.joined(separator: ", ")), ready in \(Self.formatMs(from: start, to: DispatchTime.now()))"
+        )
+    }
+}
+
 class HazkeyServer: SocketManagerDelegate {
     private let processManager: ProcessManager
     private var socketManager: SocketManager
@@ -9,6 +33,8 @@ class HazkeyServer: SocketManagerDelegate {
     private let runtimeDir: URL
     private let socketPath: String
     private let lockFilePath: String
+    private let handOffPath: String
+    private var startupTimer = StartupTimer()
 
     init() {
         let uid = getuid()
@@ -19,6 +45,7 @@ class HazkeyServer: SocketManagerDelegate {
 
         self.socketPath = "\(runtimeDir.path)/hazkey-server.\(uid).sock"
         self.lockFilePath = "\(runtimeDir.path)/hazkey-server.\(uid).lock"
+        self.handOffPath = "\(runtimeDir.path)/hazkey-server.\(uid).handoff.sock"
 
         self.processManager = ProcessManager(lockFilePath: lockFilePath)
         self.socketManager = SocketManager(socketPath: socketPath)
@@ -42,8 +69,24 @@ class HazkeyServer: SocketManagerDelegate {
                 at: runtimeDir, withIntermediateDirectories: true,
                 attributes: [FileAttributeKey.posixPermissions: 0o700])
         }
+        // a hand-off request must not kill the process before its handler is installed
+        signal(HandOff.signal, SIG_IGN)
+        var received: HandOff.Received?
+        var replacedServer = false
         do {
-            try processManager.tryLock(force: forceRestart)
+            try processManager.tryLock(force: forceRestart) { oldPid in
+                self.startupTimer.finish("lock")
+                replacedServer = true
+                // Prepare state while the old server is still serving so that the
+                // switch only costs the transfer. No conversion runs before the
+                // hand-off, so learning data the old server commits is still read.
+                self.state = HazkeyServerState()
+                self.startupTimer.finish("state")
+                received = HandOff.receive(path: self.handOffPath, from: oldPid)
+                self.startupTimer.finish("hand-off")
+                return received != nil
+            }
+            startupTimer.finish(replacedServer ? "old server exit" : "lock")
         } catch ProcessManagerError.anotherInstanceRunning {
             // NSLogged by tryLock()
             // expected exit
@@ -52,14 +95,51 @@ class HazkeyServer: SocketManagerDelegate {
             NSLog("Failed to start hazkey-server: \(error)")
             exit(1)
         }
-        self.state = HazkeyServerState()
-        self.protocolHandler = ProtocolHandler(state: self.state!)
-        try socketManager.setupSocket()
+        let state: HazkeyServerState
+        if let prepared = self.state {
+            state = prepared
+        } else {
+            state = HazkeyServerState()
+            startupTimer.finish("state")
+        }
+        self.state = state
+        self.protocolHandler = ProtocolHandler(state: state)
+        socketManager.stats = state.stats
+        socketManager.recorder = TrafficRecorder.fromEnvironment()
+        if let received = received {
+            try socketManager.adoptSocket(serverFd: received.serverFd, clientFd: received.clientFd)
+            state.restoreSession(received.message.session)
+            startupTimer.finish("restore session")
+            NSLog("Took over from hazkey-server \(received.message.version)")
+        } else {
+            try socketManager.setupSocket()
+            startupTimer.finish("socket")
+        }
+        startupTimer.log()
         // start main loop
         NSLog("start listening...")
         socketManager.startListening()
         // finish process
-        let _ = state?.saveLearningData()
+        let _ = state.saveLearningData()
+        if socketManager.handOffRequested {
+            handOff(state: state)
+        }
+    }
+
+    private func handOff(state: HazkeyServerState) {
+        let descriptors = socketManager.descriptorsForHandOff()
+        let message = Hazkey_Handoff_HandOff.with {
+            $0.version = hazkeyVersion
+            $0.clientAttached = descriptors.clientFd != nil
+            $0.session = state.sessionSnapshot()
+        }
+        if HandOff.send(
+            path: handOffPath, message: message, serverFd: descriptors.serverFd,
+            clientFd: descriptors.clientFd)
+        {
+            socketManager.markHandedOff()
+            NSLog("Handed off to replacement server")
+        }
     }
 
     func socketManager(_ manager: SocketManager, didReceiveData data: Data, from clientFd: Int32)
@@ -72,7 +152,17 @@ class HazkeyServer: SocketManagerDelegate {
         return handler.processProto(data: data)
     }
 
-    func socketManager(_ manager: SocketManager, clientDidConnect clientFd: Int32) {}
+    func socketManager(_ manager: SocketManager, clientDidConnect clientFd: Int32) {
+        state?.stats.recordClientConnected()
+    }
 
     func socketManager(_ manager: SocketManager, clientDidDisconnect clientFd: Int32) {}
+
+    func idleWorkDelayMs(for manager: SocketManager) -> Int32? {
+        return state?.speculativeConversionDelayMs
+    }
+
+    func socketManagerDidBecomeIdle(_ manager: SocketManager) {
+        state?.speculateFullConversion(shouldCancel: { manager.hasPendingRequest() })
+    }
 }
@@ -0,0 +1,173 @@
+import Foundation
+
+/// Latency histogram with fixed buckets in microseconds.
+struct LatencyHistogram {
+    static let bucketUpperBoundsUs: [UInt64] = [
+        100, 250, 500, 1_000, 2_500, 5_000, 10_000, 25_000, 50_000, 100_000, 250_000, 500_000,
+        1_000_000,
+    ]
+
+    // the last bucket collects everything above the largest bound
+    private(set) var bucketCounts = [UInt64](
+        repeating: 0, count: LatencyHistogram.bucketUpperBoundsUs.count + 1)
+    private(set) var count: UInt64 = 0
+    private(set) var sumUs: UInt64 = 0
+    private(set) var maxUs: UInt64 = 0
+
+    mutating func record(_ us: UInt64) {
+        let bucket =
+            Self.bucketUpperBoundsUs.firstIndex { us <= $0 } ?? Self.bucketUpperBoundsUs.count
+        bucketCounts[bucket] += 1
+        count += 1
+        sumUs &+= us
+        maxUs = max(maxUs, us)
+    }
+
+    func toProto() -> Hazkey_Stats_Histogram {
+        return Hazkey_Stats_Histogram.with {
+            $0.bucketUpperBoundsUs = Self.bucketUpperBoundsUs
+            $0.bucketCounts = bucketCounts
+            $0.count = count
+            $0.sumUs = sumUs
+            $0.maxUs = maxUs
+        }
+    }
+}
+
+/// Counters scraped through the GetStats request.
+final class ServerStatsCollector {
+    private struct RequestCounter {
+        var count: UInt64 = 0
+        var failures: UInt64 = 0
+        var latency = LatencyHistogram()
+    }
+
+    private let startTime = DispatchTime.now()
+
+    private var requests: [String: RequestCounter] = [:]
+    private(set) var dictionaryConversion = LatencyHistogram()
+    private(set) var zenzaiConversion = LatencyHistogram()
+    private(set) var learningSave = LatencyHistogram()
+
+    private(set) var clientConnections: UInt64 = 0
+    private(set) var socketBacklogBytes: UInt64 = 0
+    private(set) var maxSocketBacklogBytes: UInt64 = 0
+
+    static func elapsedMicroseconds(since start: DispatchTime) -> UInt64 {
+        return (DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1_000
+    }
+
+    var uptimeMs: UInt64 {
+        return Self.elapsedMicroseconds(since: startTime) / 1_000
+    }
+
+    func recordRequest(payloadType: String, elapsedUs: UInt64, succeeded: Bool) {
+        var counter = requests[payloadType] ?? RequestCounter()
+        counter.count += 1
+        if !succeeded {
+            counter.failures += 1
+        }
+        counter.latency.record(elapsedUs)
+        requests[payloadType] = counter
+    }
+
+    func recordConversion(elapsedUs: UInt64, usedZenzai: Bool) {
+        if usedZenzai {
+            zenzaiConversion.record(elapsedUs)
+        } else {
+            dictionaryConversion.record(elapsedUs)
+        }
+    }
+
+    func recordLearningSave(elapsedUs: UInt64) {
+        learningSave.record(elapsedUs)
+    }
+
+    func recordClientConnected() {
+        clientConnections += 1
+    }
+
+    /// Bytes the client had already queued when a request was read.
+    func recordSocketBacklog(bytes: UInt64) {
+        socketBacklogBytes = bytes
+        maxSocketBacklogBytes = max(maxSocketBacklogBytes, bytes)
+    }
+
+    func requestStats() -> [Hazkey_Stats_RequestStats] {
+        return requests.keys.sorted().map { payloadType in
+            let counter = requests[payloadType]!
+            return Hazkey_Stats_RequestStats.with {
+                $0.payloadType = payloadType
+                $0.count = counter.count
+                $0.failures = counter.failures
+                $0.latency = counter.latency.toProto()
+            }
+        }
+    }
+
+    func reset() {
+        requests.removeAll()
+        dictionaryConversion = LatencyHistogram()
+        zenzaiConversion = LatencyHistogram()
+        learningSave = LatencyHistogram()
+        clientConnections = 0
+        socketBacklogBytes = 0
+        maxSocketBacklogBytes = 0
+    }
+
+    static func residentSetSizeBytes() -> UInt64 {
+        // second field of /proc/self/statm is the resident page count
+        guard let statm = try? String(contentsOfFile: "/proc/self/statm", encoding: .utf8) else {
+            return 0
+        }
+        let fields = statm.split(separator: " ")
+        guard fields.count > 1, let pages = UInt64(fields[1]) else {
+            return 0
+        }
+        return pages * UInt64(sysconf(Int32(_SC_PAGESIZE)))
+    }
+}
+
+extension LRUCache.Statistics {
+    func toProto(name: String) -> Hazkey_Stats_CacheStats {
+        return Hazkey_Stats_CacheStats.with {
+            $0.name = name
+            $0.hits = hits
+            $0.misses = misses
+            $0.evictions = evictions
+            $0.invalidations = invalidations
+            $0.size = UInt32(count)
+            $0.capacity = UInt32(capacity)
+        }
+    }
+}
+
+extension Hazkey_RequestEnvelope.OneOf_Payload {
+    var payloadType: String {
+        switch self {
+        case .newComposingText: return "new_composing_text"
+        case .setContext: return "set_context"
+        case .inputChar: return "input_char"
+        case .modifierEvent: return "modifier_event"
+        case .moveCursor: return "move_cursor"
+        case .prefixComplete: return "prefix_complete"
+        case .deleteLeft: return "delete_left"
+        case .deleteRight: return "delete_right"
+        case .getComposingString: return "get_composing_string"
+        case .getHiraganaWithCursor: return "get_hiragana_with_cursor"
+        case .getCandidates: return "get_candidates"
+        case .getCurrentInputMode: return "get_current_input_mode"
+        case .saveLearningData: return "save_learning_data"
+        case .convertBatch: return "convert_batch"
+        case .getCandidatePage: return "get_candidate_page"
+        case .getConfig: return "get_config"
+        case .setConfig: return "set_config"
+        case .getDefaultProfile: return "get_default_profile"
+        case .clearAllHistory_p: return "clear_all_history"
+        case .reloadZenzaiModel: return "reload_zenzai_model"
+        case .activateProfile: return "activate_profile"
+        case .getStats: return "get_stats"
+        case .flushTrace: return "flush_trace"
+        }
+    }
+}
@@ -5,13 +5,22 @@ protocol SocketManagerDelegate: AnyObject {
         -> Data
     func socketManager(_ manager: SocketManager, clientDidConnect clientFd: Int32)
     func socketManager(_ manager: SocketManager, clientDidDisconnect clientFd: Int32)
+    /// How long the client must be quiet before socketManagerDidBecomeIdle is
+    /// called, or nil when there is no idle work.
+    func idleWorkDelayMs(for manager: SocketManager) -> Int32?
+    func socketManagerDidBecomeIdle(_ manager: SocketManager)
 }
 
 class SocketManager {
     weak var delegate: SocketManagerDelegate?
+    var stats: ServerStatsCollector?
+    var recorder: TrafficRecorder?
 
     private var signalSources: [DispatchSourceSignal] = []
     private var continueServing = true
+    // set by SIGUSR1, sent by a replacement server that wants to take over
+    private(set) var handOffRequested = false
+    private var handedOff = false
 
     private var serverFd: Int32 = -1
     private var currentClientFd: Int32?
@@ -27,35 +36,7 @@ class SocketManager {
     }
 
     func setupSocket() throws {
-        unlink(socketPath)
-
-        serverFd = socket(AF_UNIX, Int32(SOCK_STREAM.rawValue), 0)
-        guard serverFd != -1 else {
-            throw SocketError.readFailed("Failed to create socket", errno)
-        }
-
-        var addr = sockaddr_un()
-        addr.sun_family = sa_family_t(AF_UNIX)
-        strncpy(&addr.sun_path.0, socketPath, MemoryLayout.size(ofValue: addr.sun_path))
-
-        let addrSize = socklen_t(MemoryLayout.size(ofValue: addr))
-        let bindResult = withUnsafePointer(to: &addr) {
-            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
-                bind(serverFd, $0, addrSize)
-            }
-        }
-
-        guard bindResult != -1 else {
-            throw SocketError.readFailed("Failed to bind socket", errno)
-        }
-
-        guard chmod(socketPath, 0o600) != -1 else {
-            throw SocketError.readFailed("Failed to set socket permissions", errno)
-        }
-
-        guard listen(serverFd, 10) != -1 else {
-            throw SocketError.readFailed("Failed to listen", errno)
-        }
+        serverFd = try listenUnixSocket(path: socketPath, backlog: 10)
 
         // Set non-blocking
         let flags = fcntl(serverFd, F_GETFL, 0)
@@ -64,6 +45,31 @@ class SocketManager {
             NSLog("fcntl() failed")
         }
 
+        try setupStopPipe()
+    }
+
+    /// Serves on descriptors received from the server being replaced.
+    /// Both are already non-blocking.
+    func adoptSocket(serverFd: Int32, clientFd: Int32?) throws {
+        self.serverFd = serverFd
+        if let clientFd = clientFd {
+            currentClientFd = clientFd
+            delegate?.socketManager(self, clientDidConnect: clientFd)
+        }
+        try setupStopPipe()
+    }
+
+    /// Descriptors to pass to a replacement server after a hand-off request.
+    func descriptorsForHandOff() -> (serverFd: Int32, clientFd: Int32?) {
+        return (serverFd, currentClientFd)
+    }
+
+    /// The socket path now belongs to the replacement, so keep it on close.
+    func markHandedOff() {
+        handedOff = true
+    }
+
+    private func setupStopPipe() throws {
         var fds: [Int32] = [0, 0]
         guard pipe(&fds) != -1 else {
             throw SocketError.readFailed("Failed to bind pipe socket", errno)
@@ -75,12 +81,17 @@ class SocketManager {
         signal(SIGPIPE, SIG_IGN)
 
         let signalQueue = DispatchQueue(label: "dev.hiira.hazkey.server.socketmanager.signals")
-        let signals = [SIGINT, SIGTERM, SIGHUP]
+        let signals = [SIGINT, SIGTERM, SIGHUP, HandOff.signal]
 
         for sig in signals {
             let source = DispatchSource.makeSignalSource(signal: sig, queue: signalQueue)
             source.setEventHandler { [weak self] in
-                NSLog("Signal \(sig) received, shutting down...")
+                if sig == HandOff.signal {
+                    NSLog("Hand-off requested, shutting down...")
+                    self?.handOffRequested = true
+                } else {
+                    NSLog("Signal \(sig) received, shutting down...")
+                }
                 self?.continueServing = false
                 // stop poll
                 if let pipeFd = self?.pipeFds[1] {
@@ -109,7 +120,9 @@ class SocketManager {
                 pollFds.append(pollfd(fd: clientFd, events: Int16(POLLIN), revents: 0))
             }
 
-            let pollRes = poll(&pollFds, nfds_t(pollFds.count), 1000)
+            // the timeout restarts after every request, so it measures the pause
+            let idleDelayMs = delegate?.idleWorkDelayMs(for: self)
+            let pollRes = poll(&pollFds, nfds_t(pollFds.count), idleDelayMs ?? 1000)
 
             if pollRes < 0 {
                 if errno == EINTR {
@@ -122,6 +135,9 @@ class SocketManager {
 
             if pollRes == 0 {
                 // Timeout
+                if idleDelayMs != nil {
+                    delegate?.socketManagerDidBecomeIdle(self)
+                }
                 continue
             }
 
@@ -152,6 +168,18 @@ class SocketManager {
         }
     }
 
+    /// True when a request or connection is waiting, so idle work should yield.
+    func hasPendingRequest() -> Bool {
+        var pollFds = [
+            pollfd(fd: serverFd, events: Int16(POLLIN), revents: 0),
+            pollfd(fd: pipeFds[0], events: Int16(POLLIN), revents: 0),
+        ]
+        if let clientFd = currentClientFd {
+            pollFds.append(pollfd(fd: clientFd, events: Int16(POLLIN), revents: 0))
+        }
+        return poll(&pollFds, nfds_t(pollFds.count), 0) != 0
+    }
+
     private func handleNewConnection() {
         var clientAddr = sockaddr()
         var clientLen: socklen_t = socklen_t(MemoryLayout<sockaddr>.size)
@@ -202,6 +230,13 @@ class SocketManager {
             // Read message body
             let query = try readData(from: clientFd, count: Int(readLen))
             debugLog("Successfully read \(query.count) bytes")
+            recorder?.record(query)
+
+            // requests the client has already queued behind this one
+            var pendingBytes: Int32 = 0
+            if ioctl(clientFd, UInt(FIONREAD), &pendingBytes) == 0 {
+                stats?.recordSocketBacklog(bytes: UInt64(pendingBytes))
+            }
 
             // Process and respond
             let response =
@@ -265,6 +300,8 @@ class SocketManager {
             serverFd = -1
         }
 
-        unlink(socketPath)
+        if !handedOff {
+            unlink(socketPath)
+        }
     }
 }
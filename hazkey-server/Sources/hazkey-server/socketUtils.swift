@@ -68,3 +68,67 @@ func writeData(to fd: Int32, data: Data) throws {
         throw SocketError.incompleteWrite("Failed to write all bytes")
     }
 }
+
+/// Creates a Unix domain socket bound to path with owner-only permissions
+/// and starts listening on it.
+func listenUnixSocket(path: String, backlog: Int32) throws -> Int32 {
+    unlink(path)
+
+    let fd = socket(AF_UNIX, Int32(SOCK_STREAM.rawValue), 0)
+    guard fd != -1 else {
+        throw SocketError.readFailed("Failed to create socket", errno)
+    }
+
+    var addr = sockaddr_un()
+    addr.sun_family = sa_family_t(AF_UNIX)
+    strncpy(&addr.sun_path.0, path, MemoryLayout.size(ofValue: addr.sun_path))
+
+    let addrSize = socklen_t(MemoryLayout.size(ofValue: addr))
+    let bindResult = withUnsafePointer(to: &addr) {
+        $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+            bind(fd, $0, addrSize)
+        }
+    }
+
+    guard bindResult != -1 else {
+        let err = errno
+        close(fd)
+        throw SocketError.readFailed("Failed to bind socket", err)
+    }
+
+    guard chmod(path, 0o600) != -1 else {
+        let err = errno
+        close(fd)
+        throw SocketError.readFailed("Failed to set socket permissions", err)
+    }
+
+    guard listen(fd, backlog) != -1 else {
+        let err = errno
+        close(fd)
+        throw SocketError.readFailed("Failed to listen", err)
+    }
+
+    return fd
+}
+
+/// Connects to a Unix domain socket, returns -1 on failure.
+func connectUnixSocket(path: String) -> Int32 {
+    let fd = socket(AF_UNIX, Int32(SOCK_STREAM.rawValue), 0)
+    guard fd != -1 else { return -1 }
+
+    var addr = sockaddr_un()
+    addr.sun_family = sa_family_t(AF_UNIX)
+    strncpy(&addr.sun_path.0, path, MemoryLayout.size(ofValue: addr.sun_path))
+
+    let addrSize = socklen_t(MemoryLayout.size(ofValue: addr))
+    let connectResult = withUnsafePointer(to: &addr) {
+        $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+            connect(fd, $0, addrSize)
+        }
+    }
+    guard connectResult != -1 else {
+        close(fd)
+        return -1
+    }
+    return fd
+}
@@ -2,10 +2,32 @@ import Foundation
 import KanaKanjiConverterModule
 import SwiftUtils
 
+struct CandidatesCacheKey: Hashable {
+    let hiragana: String
+    let cursor: Int
+    let isSuggest: Bool
+    let optionsHash: Int
+    let leftContext: String
+}
+
+struct CachedCandidates {
+    let result: Hazkey_Commands_CandidatesResult
+    let candidates: [Candidate]
+}
+
+// Per-profile state that is expensive to rebuild on profile switches
+struct PreparedProfile {
+    let keymap: Keymap
+    let tableName: String
+    let baseConvertRequestOptions: ConvertRequestOptions
+}
+
 class HazkeyServerState {
     let serverConfig: HazkeyServerConfig
     let converter: KanaKanjiConverter
     var currentCandidateList: [Candidate]?
+    // whether currentCandidateList came from a full (non-suggest) conversion
+    var currentListIsFullConversion = false
     var composingText: ComposingTextBox = ComposingTextBox()
 
     var isShiftPressedAlone = false
@@ -16,6 +38,27 @@ class HazkeyServerState {
     var currentTableName: String
     var baseConvertRequestOptions: ConvertRequestOptions
 
+    var leftContext = ""
+    // scalars of left context the client keeps in sync, 0 when unbounded
+    private var contextWindowSize = 0
+    // bumped whenever the composing text, its context or the options change
+    private(set) var composingVersion: UInt64 = 0
+    // version whose full conversion is already in candidatesCache
+    private var convertedVersion: UInt64 = 0
+    // candidates of the last result sent to the client, the base of the next delta
+    private var servedCandidates: [Hazkey_Commands_CandidatesResult.Candidate] = []
+    // starts at random so a client never mistakes a restarted server's results for
+    // the ones it holds
+    private var servedVersion = UInt64.random(in: 1...(UInt64.max >> 1))
+    // every candidate of the paged result served last, empty if it fit one page
+    private var pagedCandidates: [Hazkey_Commands_CandidatesResult.Candidate] = []
+    let zenzaiLatency = ZenzaiLatencyController()
+    let candidatesCache = LRUCache<CandidatesCacheKey, CachedCandidates>(capacity: 64)
+    let preparedProfiles = LRUCache<String, PreparedProfile>(capacity: 4)
+    let stats = ServerStatsCollector()
+    let tracer = Tracer()
+    lazy var batchConverter = BatchConverter(dictionaryURL: serverConfig.dictionaryPath)
+
     init() {
         self.serverConfig = HazkeyServerConfig()
 
@@ -23,7 +66,8 @@ class HazkeyServerState {
 
         // Initialize keymap and table
         self.keymap = serverConfig.loadKeymap()
-        self.currentTableName = UUID().uuidString
+        self.currentTableName = Self.tableName(
+            forProfile: serverConfig.currentProfile.profileID)
         serverConfig.loadInputTable(tableName: currentTableName)
 
         // Create user state directories (history data)
@@ -59,23 +103,80 @@ class HazkeyServerState {
 
         // Initialize base convert options
         self.baseConvertRequestOptions = serverConfig.genBaseConvertRequestOptions()
+        zenzaiLatency.reset(
+            targetMs: serverConfig.currentProfile.zenzaiLatencyTargetMs,
+            maxInferenceLimit: serverConfig.currentProfile.zenzaiInferLimit)
+        preparedProfiles.setValue(
+            PreparedProfile(
+                keymap: keymap, tableName: currentTableName,
+                baseConvertRequestOptions: baseConvertRequestOptions),
+            forKey: serverConfig.currentProfile.profileID)
     }
 
-    func setContext(surroundingText: String, anchorIndex: Int) -> Hazkey_ResponseEnvelope {
-        let leftContext = String(surroundingText.prefix(anchorIndex))
-        baseConvertRequestOptions.zenzaiMode = serverConfig.genZenzaiMode(
-            leftContext: leftContext)
+    /// The client sends either the whole left context or a delta against the
+    /// last one: drop the first dropPrefix scalars, then append context. The
+    /// hash of the result detects a client and server that drifted apart.
+    func setContext(_ request: Hazkey_Commands_SetContext) -> Hazkey_ResponseEnvelope {
+        if request.isDelta {
+            leftContext =
+                String(
+                    String.UnicodeScalarView(
+                        leftContext.unicodeScalars.dropFirst(max(0, Int(request.dropPrefix)))))
+                + request.context
+        } else {
+            // the anchor counts Unicode scalars, as fcitx does
+            leftContext = String(
+                String.UnicodeScalarView(
+                    request.context.unicodeScalars.prefix(max(0, Int(request.anchor)))))
+        }
+        contextWindowSize = Int(request.windowSize)
+        composingVersion &+= 1
+
+        if request.contextHash != 0 && Self.contextHash(leftContext) != request.contextHash {
+            leftContext = ""
+            updateZenzaiMode()
+            return Hazkey_ResponseEnvelope.with {
+                $0.status = .failed
+                $0.errorMessage = "Left context is out of sync."
+            }
+        }
+        updateZenzaiMode()
 
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
         }
     }
 
+    /// 64-bit FNV-1a over UTF-8, computed the same way by the client.
+    static func contextHash(_ text: String) -> UInt64 {
+        var hash: UInt64 = 0xcbf2_9ce4_8422_2325
+        for byte in text.utf8 {
+            hash ^= UInt64(byte)
+            hash = hash &* 0x0000_0100_0000_01b3
+        }
+        return hash
+    }
+
+    /// Keeps the last contextWindowSize scalars, as the client does.
+    private func trimToContextWindow(_ context: String) -> String {
+        let scalars = context.unicodeScalars
+        guard contextWindowSize > 0, scalars.count > contextWindowSize else { return context }
+        return String(String.UnicodeScalarView(scalars.suffix(contextWindowSize)))
+    }
+
+    private func updateZenzaiMode() {
+        baseConvertRequestOptions.zenzaiMode = serverConfig.genZenzaiMode(
+            leftContext: leftContext,
+            inferenceLimit: zenzaiLatency.isEnabled ? zenzaiLatency.currentInferenceLimit : nil)
+    }
+
     /// ComposingText
 
     func createComposingTextInstanse() -> Hazkey_ResponseEnvelope {
         composingText = ComposingTextBox()
+        composingVersion &+= 1
         currentCandidateList = nil
+        currentListIsFullConversion = false
         isSubInputMode = false
         isShiftPressedAlone = false
         return Hazkey_ResponseEnvelope.with {
@@ -83,35 +184,48 @@ class HazkeyServerState {
         }
     }
 
+    /// Inserts every character of inputString, as if typed one by one.
     func inputChar(inputString: String) -> Hazkey_ResponseEnvelope {
-        guard let inputChar = inputString.first else {
+        guard !inputString.isEmpty else {
             return Hazkey_ResponseEnvelope.with {
                 $0.status = .failed
-                $0.errorMessage = "failed to get first unicode character"
+                $0.errorMessage = "empty input"
             }
         }
-        isSubInputMode =
-            isSubInputMode
-            || (isShiftPressedAlone
-                && serverConfig.getSubModeEntryPointChars().contains(inputChar))
-        isShiftPressedAlone = false
-        if isSubInputMode {
-            composingText.value.insertAtCursorPosition(String(inputChar), inputStyle: .direct)
-        } else {
-            let piece: InputPiece
-            if let (intentionChar, overrideInputChar) = keymap[inputChar] {
-                piece = .key(
-                    intention: intentionChar, input: overrideInputChar ?? inputChar, modifiers: [])
+        // consecutive mapped characters are inserted in one call
+        var mappedElements: [ComposingText.InputElement] = []
+        for inputChar in inputString {
+            isSubInputMode =
+                isSubInputMode
+                || (isShiftPressedAlone
+                    && serverConfig.getSubModeEntryPointChars().contains(inputChar))
+            isShiftPressedAlone = false
+            if isSubInputMode {
+                if !mappedElements.isEmpty {
+                    composingText.value.insertAtCursorPosition(mappedElements)
+                    mappedElements.removeAll(keepingCapacity: true)
+                }
+                composingText.value.insertAtCursorPosition(String(inputChar), inputStyle: .direct)
             } else {
-                piece = .character(inputChar)
-            }
+                let piece: InputPiece
+                if let (intentionChar, overrideInputChar) = keymap[inputChar] {
+                    piece = .key(
+                        intention: intentionChar, input: overrideInputChar ?? inputChar,
+                        modifiers: [])
+                } else {
+                    piece = .character(inputChar)
+                }
 
-            composingText.value.insertAtCursorPosition([
-                ComposingText.InputElement(
-                    piece: piece,
-                    inputStyle: .mapped(id: .tableName(currentTableName)))
-            ])
+                mappedElements.append(
+                    ComposingText.InputElement(
+                        piece: piece,
+                        inputStyle: .mapped(id: .tableName(currentTableName))))
+            }
+        }
+        if !mappedElements.isEmpty {
+            composingText.value.insertAtCursorPosition(mappedElements)
         }
+        composingVersion &+= 1
         return Hazkey_ResponseEnvelope.with { $0.status = .success }
     }
 
@@ -151,14 +265,27 @@ class HazkeyServerState {
             $0.status = .success
             $0.currentInputModeInfo = Hazkey_Commands_CurrentInputModeInfo.with {
                 $0.inputMode = isSubInputMode ? .direct : .normal
+                $0.submodeEntryPointChars = String(serverConfig.getSubModeEntryPointChars())
             }
         }
     }
 
+    /// Takes over the submode state from a client that runs the Shift state machine
+    /// itself and sends it along with its next command.
+    func applyInputModeState(_ modeState: Hazkey_Commands_InputModeState) {
+        isSubInputMode = modeState.subInputMode
+        isShiftPressedAlone = modeState.shiftPressedAlone
+    }
+
     func saveLearningData() -> Hazkey_ResponseEnvelope {
         if learningDataNeedsCommit {
+            let saveStart = DispatchTime.now()
             converter.commitUpdateLearningData()
+            stats.recordLearningSave(
+                elapsedUs: ServerStatsCollector.elapsedMicroseconds(since: saveStart))
             learningDataNeedsCommit = false
+            candidatesCache.removeAll()
+            composingVersion &+= 1
         }
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
@@ -167,6 +294,7 @@ class HazkeyServerState {
 
     func deleteLeft() -> Hazkey_ResponseEnvelope {
         composingText.value.deleteBackwardFromCursorPosition(count: 1)
+        composingVersion &+= 1
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
         }
@@ -174,6 +302,7 @@ class HazkeyServerState {
 
     func deleteRight() -> Hazkey_ResponseEnvelope {
         composingText.value.deleteForwardFromCursorPosition(count: 1)
+        composingVersion &+= 1
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
         }
@@ -185,6 +314,17 @@ class HazkeyServerState {
             converter.setCompletedData(completedCandidate)
             converter.updateLearningData(completedCandidate)
             learningDataNeedsCommit = true
+            candidatesCache.removeAll()
+            // Its key includes the left context, so it is only hit if the
+            // client's context update matched the guess.
+            if remaindersAreReusable,
+                let speculated = speculativeRemainders[composingText.value.toHiragana()]
+            {
+                candidatesCache.setValue(speculated.value, forKey: speculated.key)
+            }
+            speculativeRemainders.removeAll()
+            currentListIsFullConversion = false
+            composingVersion &+= 1
         } else {
             return Hazkey_ResponseEnvelope.with {
                 $0.status = .failed
@@ -198,6 +338,7 @@ class HazkeyServerState {
 
     func moveCursor(offset: Int) -> Hazkey_ResponseEnvelope {
         _ = composingText.value.moveCursorFromCursorPosition(count: offset)
+        composingVersion &+= 1
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
         }
@@ -279,7 +420,139 @@ class HazkeyServerState {
     /// Candidates
 
     // TODO: return error message
-    func getCandidates(is_suggest: Bool) -> Hazkey_ResponseEnvelope {
+    /// Speculative conversions pass updatesCurrentList: false so that the list
+    /// the client is showing, which completePrefix indexes into, stays intact.
+    /// deltaBaseVersion is the version of the last result the client holds; when it is
+    /// the one served last, the response carries only the edits from it.
+    /// A paged full conversion returns the first page only; the client asks for the rest
+    /// with getCandidatePage while that page is shown.
+    func getCandidates(
+        is_suggest: Bool, updatesCurrentList: Bool = true, deltaBaseVersion: UInt64? = nil,
+        paged: Bool = false
+    )
+        -> Hazkey_ResponseEnvelope
+    {
+        let candidates = convertCandidates(
+            isSuggest: is_suggest, updatesCurrentList: updatesCurrentList)
+        guard updatesCurrentList else {
+            return Hazkey_ResponseEnvelope.with {
+                $0.status = .success
+                $0.candidates = candidates.value.result
+            }
+        }
+
+        var result = candidates.value.result
+        pagedCandidates = []
+        if paged && !is_suggest {
+            let pageSize = max(Int(result.pageSize), 1)
+            result.totalCount = Int32(result.candidates.count)
+            if result.candidates.count > pageSize {
+                pagedCandidates = result.candidates
+                result.candidates = Array(result.candidates.prefix(pageSize))
+            }
+        }
+        result = versionedResult(result, deltaBaseVersion: deltaBaseVersion)
+        return Hazkey_ResponseEnvelope.with {
+            $0.status = .success
+            $0.candidates = result
+        }
+    }
+
+    /// Candidates past the first page of the paged full conversion served last.
+    func getCandidatePage(_ request: Hazkey_Commands_GetCandidatePage) -> Hazkey_ResponseEnvelope {
+        guard request.version == servedVersion, !pagedCandidates.isEmpty else {
+            return Hazkey_ResponseEnvelope.with {
+                $0.status = .failed
+                $0.errorMessage = "Candidate list has changed."
+            }
+        }
+        let start = min(max(Int(request.offset), 0), pagedCandidates.count)
+        let end = min(start + max(Int(request.count), 0), pagedCandidates.count)
+        return Hazkey_ResponseEnvelope.with {
+            $0.status = .success
+            $0.candidates = Hazkey_Commands_CandidatesResult.with {
+                $0.candidates = Array(pagedCandidates[start..<end])
+                $0.version = servedVersion
+                $0.totalCount = Int32(pagedCandidates.count)
+            }
+        }
+    }
+
+    /// Stamps a result served to the client with a new version and, if the client holds
+    /// the previously served one, replaces the candidates with the edits from it.
+    private func versionedResult(
+        _ result: Hazkey_Commands_CandidatesResult, deltaBaseVersion: UInt64?
+    ) -> Hazkey_Commands_CandidatesResult {
+        var result = result
+        let previous = servedCandidates
+        let previousVersion = servedVersion
+        servedCandidates = result.candidates
+        servedVersion &+= 1
+        result.version = servedVersion
+
+        guard deltaBaseVersion == previousVersion else { return result }
+        let edits = Self.candidateEdits(from: previous, to: result.candidates)
+        // not worth it when most of the list changed
+        guard edits.count < result.candidates.count else { return result }
+        result.candidates = []
+        result.isDelta = true
+        result.baseVersion = previousVersion
+        result.edits = edits
+        return result
+    }
+
+    /// Edits that turn old into new when applied in order. The common head and tail are
+    /// kept, so a candidate inserted or removed near either end costs one edit.
+    static func candidateEdits(
+        from old: [Hazkey_Commands_CandidatesResult.Candidate],
+        to new: [Hazkey_Commands_CandidatesResult.Candidate]
+    ) -> [Hazkey_Commands_CandidatesResult.Edit] {
+        var head = 0
+        while head < old.count && head < new.count && old[head] == new[head] {
+            head += 1
+        }
+        var tail = 0
+        while tail < old.count - head && tail < new.count - head
+            && old[old.count - 1 - tail] == new[new.count - 1 - tail]
+        {
+            tail += 1
+        }
+        let oldMiddle = old.count - head - tail
+        let newMiddle = new.count - head - tail
+        let shared = min(oldMiddle, newMiddle)
+
+        var edits: [Hazkey_Commands_CandidatesResult.Edit] = []
+        for index in head..<(head + shared) where old[index] != new[index] {
+            edits.append(
+                .with {
+                    $0.op = .replace
+                    $0.index = Int32(index)
+                    $0.candidate = new[index]
+                })
+        }
+        for _ in shared..<max(shared, oldMiddle) {
+            edits.append(
+                .with {
+                    $0.op = .remove
+                    $0.index = Int32(head + shared)
+                })
+        }
+        for index in (head + shared)..<(head + max(shared, newMiddle)) {
+            edits.append(
+                .with {
+                    $0.op = .insert
+                    $0.index = Int32(index)
+                    $0.candidate = new[index]
+                })
+        }
+        return edits
+    }
+
+    private func convertCandidates(isSuggest is_suggest: Bool, updatesCurrentList: Bool)
+        -> (key: CandidatesCacheKey, value: CachedCandidates)
+    {
+        let traceStart = tracer.begin()
+        defer { tracer.end("HazkeyServerState.getCandidates", start: traceStart) }
 
         func canAppend(
             isSuggest: Bool,
@@ -330,21 +603,70 @@ class HazkeyServerState {
 
         options.requireJapanesePrediction = usePrediction ? .manualMix : .disabled
 
+        let useZenzai =
+            serverConfig.isZenzaiEnabled && zenzaiLatency.shouldUseZenzai(isSuggest: is_suggest)
+        if !useZenzai {
+            options.zenzaiMode = .off
+        }
+
+        var optionsHasher = Hasher()
+        optionsHasher.combine(serverConfig.currentProfile.profileID)
+        optionsHasher.combine(N_best)
+        optionsHasher.combine(usePrediction)
+        optionsHasher.combine(useZenzai)
+        optionsHasher.combine(zenzaiLatency.currentInferenceLimit)
+        let cacheKey = CandidatesCacheKey(
+            hiragana: composingText.value.toHiragana(),
+            cursor: composingText.value.convertTargetCursorPosition,
+            isSuggest: is_suggest,
+            optionsHash: optionsHasher.finalize(),
+            // the context only reaches the converter through Zenzai
+            leftContext: useZenzai ? leftContext : "")
+        if !is_suggest {
+            convertedVersion = composingVersion
+        }
+        if updatesCurrentList {
+            currentListIsFullConversion = !is_suggest
+        }
+        if let cached = candidatesCache.value(forKey: cacheKey) {
+            if updatesCurrentList {
+                self.currentCandidateList = cached.candidates
+            }
+            return (cacheKey, cached)
+        }
+
         var copiedComposingText = composingText.value
 
         if !is_suggest {
             let _ = copiedComposingText.moveCursorFromCursorPosition(
                 count: copiedComposingText.toHiragana().count)
-            copiedComposingText.insertAtCursorPosition(
+            var separatedComposingText = copiedComposingText
+            separatedComposingText.insertAtCursorPosition(
                 [
                     ComposingText.InputElement(
                         piece: .compositionSeparator,
                         inputStyle: .mapped(id: .tableName(currentTableName)))
                 ])
+            // The separator is only needed to flush pending input such as a trailing "n".
+            // Otherwise keep the input identical to the suggest request so that the
+            // converter can reuse the lattice it has already built for it.
+            if separatedComposingText.convertTarget != copiedComposingText.convertTarget {
+                copiedComposingText = separatedComposingText
+            }
         }
 
         var candidatesResult = Hazkey_Commands_CandidatesResult()
+        let convertStart = DispatchTime.now()
+        let converterTraceStart = tracer.begin()
         let converted = converter.requestCandidates(copiedComposingText, options: options)
+        tracer.end("KanaKanjiConverter.requestCandidates", start: converterTraceStart)
+        let convertElapsedUs = ServerStatsCollector.elapsedMicroseconds(since: convertStart)
+        stats.recordConversion(elapsedUs: convertElapsedUs, usedZenzai: useZenzai)
+        if useZenzai {
+            if zenzaiLatency.record(elapsedMs: Double(convertElapsedUs) / 1_000) {
+                updateZenzaiMode()
+            }
+        }
         let hiraganaPreedit = copiedComposingText.toHiragana()
         let hiraganaPreeditLen = hiraganaPreedit.count
         var serverCandidates: [Candidate] = []
@@ -390,7 +712,9 @@ class HazkeyServerState {
             )
         }
 
-        self.currentCandidateList = serverCandidates
+        if updatesCurrentList {
+            self.currentCandidateList = serverCandidates
+        }
         candidatesResult.candidates = clientCandidates
 
         // Do not automatically convert if there is only one character
@@ -420,32 +744,311 @@ class HazkeyServerState {
             }
         }()
 
+        let cached = CachedCandidates(result: candidatesResult, candidates: serverCandidates)
+        candidatesCache.setValue(cached, forKey: cacheKey)
+        return (cacheKey, cached)
+    }
+
+    /// Speculative conversion
+
+    // Full conversions of what remains after completing the prefixes in the
+    // shown list, keyed by the remaining hiragana. Computed for the list shown
+    // at remaindersBaseVersion.
+    private var speculativeRemainders: [String: (key: CandidatesCacheKey, value: CachedCandidates)] =
+        [:]
+    private var remaindersBaseVersion: UInt64 = 0
+    // version whose remainders have all been converted
+    private var remaindersVersion: UInt64 = 0
+    // distinct prefix lengths to convert ahead, in candidate order
+    private static let maxSpeculativeRemainders = 3
+
+    // A remainder converted ahead of time ranks words as they were before
+    // completePrefix learned the completed one, so it is only reused when
+    // nothing is learned, and not computed otherwise.
+    private var remaindersAreReusable: Bool {
+        baseConvertRequestOptions.learningType != .inputAndOutput
+    }
+
+    /// How long the client must pause before conversions are computed ahead
+    /// of time, or nil when it is disabled or there is nothing left to do.
+    var speculativeConversionDelayMs: Int32? {
+        let delayMs = serverConfig.currentProfile.speculativeConversionDelayMs
+        let needsRemainders =
+            currentListIsFullConversion && remaindersAreReusable
+            && remaindersVersion != composingVersion
+        guard delayMs > 0, convertedVersion != composingVersion || needsRemainders,
+            !composingText.value.convertTarget.isEmpty
+        else { return nil }
+        return delayMs
+    }
+
+    /// Runs the conversion that Space would request while typing is paused, so
+    /// that the request is answered from candidatesCache. While a full
+    /// candidate list is shown and nothing is learned, converts what would
+    /// remain after each of its prefix candidates instead, so the next segment
+    /// shows without a stall.
+    /// KanaKanjiConverter cannot be interrupted, so shouldCancel is checked
+    /// before each conversion; a key that arrives during one waits. That can
+    /// stall the first key after a pause, so profiles ship with it disabled and
+    /// hazkey-settings does not offer it; it can only be set in the config file.
+    func speculateFullConversion(shouldCancel: () -> Bool) {
+        guard speculativeConversionDelayMs != nil else { return }
+        if convertedVersion != composingVersion {
+            guard !shouldCancel() else { return }
+            let start = DispatchTime.now()
+            _ = getCandidates(is_suggest: false, updatesCurrentList: false)
+            debugLog(
+                "Speculative conversion took \(ServerStatsCollector.elapsedMicroseconds(since: start))us"
+            )
+        } else if currentListIsFullConversion && remaindersAreReusable {
+            speculateRemainders(shouldCancel: shouldCancel)
+        }
+    }
+
+    private func speculateRemainders(shouldCancel: () -> Bool) {
+        guard let shownList = currentCandidateList else { return }
+        if remaindersBaseVersion != composingVersion {
+            speculativeRemainders.removeAll()
+            remaindersBaseVersion = composingVersion
+        }
+
+        let savedComposingText = composingText.value
+        let savedLeftContext = leftContext
+        defer {
+            composingText.value = savedComposingText
+            leftContext = savedLeftContext
+            // not a saved copy: the latency controller may have changed the limit
+            updateZenzaiMode()
+        }
+
+        var remainingReadings: Set<String> = []
+        for candidate in shownList {
+            var remainder = savedComposingText
+            remainder.prefixComplete(composingCount: candidate.composingCount)
+            let reading = remainder.toHiragana()
+            guard !reading.isEmpty, !remainingReadings.contains(reading) else { continue }
+            guard remainingReadings.count < Self.maxSpeculativeRemainders else { break }
+            remainingReadings.insert(reading)
+            if speculativeRemainders[reading] != nil { continue }
+            guard !shouldCancel() else { return }
+
+            // the state completePrefix and the client's context update will produce
+            composingText.value = remainder
+            leftContext = trimToContextWindow(savedLeftContext + candidate.text)
+            updateZenzaiMode()
+            let start = DispatchTime.now()
+            speculativeRemainders[reading] = convertCandidates(
+                isSuggest: false, updatesCurrentList: false)
+            debugLog(
+                "Speculative remainder conversion took \(ServerStatsCollector.elapsedMicroseconds(since: start))us"
+            )
+        }
+        remaindersVersion = composingVersion
+    }
+
+    /// Batch conversion
+
+    func convertBatch(_ request: Hazkey_Commands_ConvertBatch) -> Hazkey_ResponseEnvelope {
+        if request.useZenzai && !serverConfig.isZenzaiEnabled {
+            return Hazkey_ResponseEnvelope.with {
+                $0.status = .failed
+                $0.errorMessage = "Zenzai is not enabled in the current profile."
+            }
+        }
+        let nBest =
+            request.nBest > 0
+            ? Int(request.nBest) : Int(serverConfig.currentProfile.numCandidatesPerPage)
+        let serverConfig = self.serverConfig
+        let results = batchConverter.convert(
+            items: request.items,
+            baseOptions: baseConvertRequestOptions,
+            nBest: nBest,
+            zenzaiMode: request.useZenzai
+                ? { serverConfig.genZenzaiMode(leftContext: $0) } : nil)
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
-            $0.candidates = candidatesResult
+            $0.convertBatchResult = Hazkey_Commands_ConvertBatchResult.with {
+                $0.items = results
+            }
         }
     }
 
     func clearProfileLearningData() -> Hazkey_ResponseEnvelope {
         converter.resetMemory()
+        candidatesCache.removeAll()
         return Hazkey_ResponseEnvelope.with {
             $0.status = .success
         }
     }
 
-    func reinitializeConfiguration() {
-        NSLog("Reinitializing state configuration...")
+    func activateProfile(profileID: String) -> Hazkey_ResponseEnvelope {
+        guard serverConfig.selectProfile(profileID: profileID) else {
+            return Hazkey_ResponseEnvelope.with {
+                $0.status = .failed
+                $0.errorMessage = "Profile \(profileID) not found."
+            }
+        }
+        applyCurrentProfile()
+        // the composition was built with the previous profile's input table
+        return createComposingTextInstanse()
+    }
 
-        self.keymap = serverConfig.loadKeymap()
+    /// Input style name of a profile's table. Stable, so preparing a profile
+    /// again after an eviction replaces its table instead of registering
+    /// another one with InputStyleManager.
+    static func tableName(forProfile profileID: String) -> String {
+        return "hazkey-profile-\(profileID)"
+    }
+
+    /// Switches keymap, input table and convert options to the current profile,
+    /// reusing the prepared set when the profile was used recently.
+    private func applyCurrentProfile() {
+        let profileID = serverConfig.currentProfile.profileID
+        let prepared: PreparedProfile
+        if let cached = preparedProfiles.value(forKey: profileID) {
+            prepared = cached
+        } else {
+            let tableName = Self.tableName(forProfile: profileID)
+            serverConfig.loadInputTable(tableName: tableName)
+            prepared = PreparedProfile(
+                keymap: serverConfig.loadKeymap(),
+                tableName: tableName,
+                baseConvertRequestOptions: serverConfig.genBaseConvertRequestOptions())
+            preparedProfiles.setValue(prepared, forKey: profileID)
+        }
 
-        let newTableName = UUID().uuidString
-        serverConfig.loadInputTable(tableName: newTableName)
-        self.currentTableName = newTableName
+        self.keymap = prepared.keymap
+        self.currentTableName = prepared.tableName
+        self.baseConvertRequestOptions = prepared.baseConvertRequestOptions
+        zenzaiLatency.reset(
+            targetMs: serverConfig.currentProfile.zenzaiLatencyTargetMs,
+            maxInferenceLimit: serverConfig.currentProfile.zenzaiInferLimit)
+        updateZenzaiMode()
+        composingVersion &+= 1
+    }
 
-        self.baseConvertRequestOptions = serverConfig.genBaseConvertRequestOptions()
+    func getStats(reset: Bool) -> Hazkey_ResponseEnvelope {
+        let latency = zenzaiLatency.snapshot()
+        let serverStats = Hazkey_Stats_ServerStats.with {
+            $0.version = hazkeyVersion
+            $0.uptimeMs = stats.uptimeMs
+            $0.rssBytes = ServerStatsCollector.residentSetSizeBytes()
+            $0.activeProfileID = serverConfig.currentProfile.profileID
+            $0.requests = stats.requestStats()
+            $0.dictionaryConversion = stats.dictionaryConversion.toProto()
+            $0.zenzaiConversion = stats.zenzaiConversion.toProto()
+            $0.learningSave = stats.learningSave.toProto()
+            $0.caches = [
+                candidatesCache.statistics().toProto(name: "candidates"),
+                preparedProfiles.statistics().toProto(name: "profiles"),
+            ]
+            $0.zenzai = Hazkey_Stats_ZenzaiStats.with {
+                $0.modelAvailable = serverConfig.zenzaiAvailable
+                $0.enabled = serverConfig.isZenzaiEnabled
+                $0.modelPath = serverConfig.zenzaiModelPath?.path ?? ""
+                $0.backendDevice = serverConfig.currentProfile.zenzaiBackendDeviceName
+                $0.latencyTargetMs = Int32(latency.targetMs)
+                $0.maxInferenceLimit = Int32(latency.maxInferenceLimit)
+                $0.currentInferenceLimit = Int32(latency.currentInferenceLimit)
+                $0.skipsSuggest = latency.skipsSuggest
+                $0.skippedSuggests = UInt64(latency.skippedSuggests)
+                $0.limitAdjustments = UInt64(latency.adjustments)
+                $0.p50LatencyUs = UInt64(latency.p50Ms * 1_000)
+                $0.p95LatencyUs = UInt64(latency.p95Ms * 1_000)
+            }
+            $0.clientConnections = stats.clientConnections
+            $0.socketBacklogBytes = stats.socketBacklogBytes
+            $0.maxSocketBacklogBytes = stats.maxSocketBacklogBytes
+        }
+        if reset {
+            stats.reset()
+        }
+        return Hazkey_ResponseEnvelope.with {
+            $0.status = .success
+            $0.serverStats = serverStats
+        }
+    }
+
+    /// Hand-off
+
+    func sessionSnapshot() -> Hazkey_Handoff_SessionState {
+        return Hazkey_Handoff_SessionState.with {
+            $0.input = composingText.value.input.compactMap { element in
+                var proto = Hazkey_Handoff_InputElement()
+                switch element.piece {
+                case .character(let char):
+                    proto.character = String(char)
+                case .key(let intention, let input, _):
+                    proto.isKey = true
+                    proto.character = String(input)
+                    proto.intention = intention.map { String($0) } ?? ""
+                default:
+                    // separators are only inserted into copies for conversion
+                    return nil
+                }
+                if case .direct = element.inputStyle {
+                    proto.direct = true
+                }
+                return proto
+            }
+            $0.cursor = Int32(composingText.value.convertTargetCursorPosition)
+            $0.subInputMode = isSubInputMode
+            $0.shiftPressedAlone = isShiftPressedAlone
+            $0.leftContext = leftContext
+            $0.activeProfileID = serverConfig.currentProfile.profileID
+        }
+    }
+
+    func restoreSession(_ session: Hazkey_Handoff_SessionState) {
+        if session.activeProfileID != serverConfig.currentProfile.profileID,
+            serverConfig.selectProfile(profileID: session.activeProfileID)
+        {
+            applyCurrentProfile()
+        }
+        leftContext = session.leftContext
+        updateZenzaiMode()
+
+        // input tables are registered per process, so map onto this one's
+        let elements = session.input.compactMap { proto -> ComposingText.InputElement? in
+            guard let char = proto.character.first else { return nil }
+            let piece: InputPiece =
+                proto.isKey
+                ? .key(intention: proto.intention.first, input: char, modifiers: [])
+                : .character(char)
+            return ComposingText.InputElement(
+                piece: piece,
+                inputStyle: proto.direct ? .direct : .mapped(id: .tableName(currentTableName)))
+        }
+        composingText = ComposingTextBox()
+        composingText.value.insertAtCursorPosition(elements)
+        _ = composingText.value.moveCursorFromCursorPosition(
+            count: Int(session.cursor) - composingText.value.convertTargetCursorPosition)
+        composingVersion &+= 1
+        currentCandidateList = nil
+        currentListIsFullConversion = false
+        isSubInputMode = session.subInputMode
+        isShiftPressedAlone = session.shiftPressedAlone
+
+        if !elements.isEmpty {
+            // warm the converter and candidates cache for the next keystroke
+            _ = getCandidates(is_suggest: true)
+        }
+        NSLog("Restored session with \(elements.count) input elements")
+    }
+
+    func reinitializeConfiguration() {
+        NSLog("Reinitializing state configuration...")
+
+        // profiles may have changed, so drop every prepared set
+        preparedProfiles.removeAll()
+        self.leftContext = ""
+        applyCurrentProfile()
+        candidatesCache.removeAll()
 
         self.composingText = ComposingTextBox()
+        composingVersion &+= 1
         self.currentCandidateList = nil
+        self.currentListIsFullConversion = false
         self.isSubInputMode = false
         self.isShiftPressedAlone = false
 
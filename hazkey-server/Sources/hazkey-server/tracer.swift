@@ -0,0 +1,78 @@
+import Foundation
+
+/// Opt-in span recorder enabled by the HAZKEY_TRACE environment variable.
+/// Spans are kept in a fixed-size ring buffer and exported as Chrome trace
+/// events when the client sends FlushTrace.
+final class Tracer {
+    private struct Span {
+        var name: StaticString
+        var traceID: UInt64
+        var startUs: UInt64
+        var durationUs: UInt64
+    }
+
+    private let capacity = 8192
+
+    let isEnabled: Bool
+    // trace ID of the request being processed, 0 if the client sent none
+    var currentTraceID: UInt64 = 0
+
+    private var spans: [Span] = []
+    private var nextIndex = 0
+
+    init(isEnabled: Bool = Tracer.enabledByEnvironment()) {
+        self.isEnabled = isEnabled
+        if isEnabled {
+            spans.reserveCapacity(capacity)
+            NSLog("Tracing enabled")
+        }
+    }
+
+    static func enabledByEnvironment() -> Bool {
+        guard let value = ProcessInfo.processInfo.environment["HAZKEY_TRACE"] else {
+            return false
+        }
+        return !value.isEmpty && value != "0"
+    }
+
+    /// CLOCK_MONOTONIC in microseconds, the same clock the addon uses,
+    /// so that spans from both processes line up in one trace.
+    static func nowUs() -> UInt64 {
+        var ts = timespec()
+        clock_gettime(CLOCK_MONOTONIC, &ts)
+        return UInt64(ts.tv_sec) * 1_000_000 + UInt64(ts.tv_nsec) / 1_000
+    }
+
+    /// Returns the start timestamp to pass to end(_:start:).
+    @inline(__always)
+    func begin() -> UInt64 {
+        return isEnabled ? Self.nowUs() : 0
+    }
+
+    @inline(__always)
+    func end(_ name: StaticString, start: UInt64) {
+        guard isEnabled else { return }
+        let span = Span(
+            name: name, traceID: currentTraceID, startUs: start,
+            durationUs: Self.nowUs() - start)
+        if spans.count < capacity {
+            spans.append(span)
+        } else {
+            spans[nextIndex] = span
+        }
+        nextIndex = (nextIndex + 1) % capacity
+    }
+
+    /// Comma-separated trace event objects, oldest first, without the
+    /// enclosing array. The buffer is cleared afterwards.
+    func exportEvents() -> String {
+        let pid = getpid()
+        let ordered = spans.count < capacity ? spans : Array(spans[nextIndex...] + spans[..<nextIndex])
+        let events = ordered.map { span in
+            "{\"name\":\"\(span.name)\",\"cat\":\"hazkey-server\",\"ph\":\"X\",\"ts\":\(span.startUs),\"dur\":\(span.durationUs),\"pid\":\(pid),\"tid\":\(pid),\"args\":{\"trace_id\":\(span.traceID)}}"
+        }
+        spans.removeAll(keepingCapacity: true)
+        nextIndex = 0
+        return events.joined(separator: ",\n")
+    }
+}
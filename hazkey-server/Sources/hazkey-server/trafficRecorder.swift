@@ -0,0 +1,71 @@
+import Foundation
+
+/// Opt-in log of the request frames the server receives, enabled by setting
+/// HAZKEY_RECORD to the path of the log. It is meant for replaying a real
+/// session against another server build with hazkey-traffic-replay. The log
+/// holds everything the user typed, so only the owner can read it. The
+/// server's pid is appended to the path, so a server that takes over the
+/// socket does not overwrite the log of the one it replaced.
+///
+/// Format: the 8-byte magic "HZKREC\0\u{1}", then for every request a varint
+/// of the microseconds since the previous request (since recording started
+/// for the first one), a varint of the frame length and the frame itself.
+final class TrafficRecorder {
+    static let magic: [UInt8] = Array("HZKREC".utf8) + [0, 1]
+
+    private let file: UnsafeMutablePointer<FILE>
+    private var lastUs: UInt64
+    private var buffer: [UInt8] = []
+
+    init?(path: String) {
+        let fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode_t(0o600))
+        guard fd >= 0, let file = fdopen(fd, "w") else {
+            NSLog("Failed to open request log \(path): \(errno)")
+            if fd >= 0 {
+                close(fd)
+            }
+            return nil
+        }
+        self.file = file
+        self.lastUs = Tracer.nowUs()
+        _ = fwrite(Self.magic, 1, Self.magic.count, file)
+        fflush(file)
+        NSLog("Recording requests to \(path)")
+    }
+
+    static func fromEnvironment() -> TrafficRecorder? {
+        guard let path = ProcessInfo.processInfo.environment["HAZKEY_RECORD"],
+            !path.isEmpty
+        else {
+            return nil
+        }
+        return TrafficRecorder(path: "\(path).\(getpid())")
+    }
+
+    deinit {
+        fclose(file)
+    }
+
+    func record(_ frame: Data) {
+        let now = Tracer.nowUs()
+        buffer.removeAll(keepingCapacity: true)
+        Self.appendVarint(now - lastUs, to: &buffer)
+        Self.appendVarint(UInt64(frame.count), to: &buffer)
+        buffer.append(contentsOf: frame)
+        lastUs = now
+        buffer.withUnsafeBytes { bytes in
+            _ = fwrite(bytes.baseAddress, 1, bytes.count, file)
+        }
+        // flushed per request so the log survives the crash it may explain
+        fflush(file)
+    }
+
+    static func appendVarint(_ value: UInt64, to buffer: inout [UInt8]) {
+        var value = value
+        while value >= 0x80 {
+            buffer.append(UInt8(truncatingIfNeeded: value) | 0x80)
+            value >>= 7
+        }
+        buffer.append(UInt8(value))
+    }
+}
@@ -0,0 +1,129 @@
+import Foundation
+
+/// Keeps Zenzai conversion latency under the profile's p95 target by adjusting
+/// the inference limit at runtime. When even the smallest limit is too slow,
+/// Zenzai is skipped for suggest requests until latency recovers.
+final class ZenzaiLatencyController {
+    struct Snapshot {
+        var targetMs: Double
+        var maxInferenceLimit: Int
+        var currentInferenceLimit: Int
+        var skipsSuggest: Bool
+        var sampleCount: Int
+        var p50Ms: Double
+        var p95Ms: Double
+        var adjustments: Int
+        var skippedSuggests: Int
+    }
+
+    // recent samples used for the percentile estimate
+    private let windowSize = 64
+    // minimum samples observed with the current limit before adjusting again
+    private let minSamplesForAdjustment = 8
+    // grow the limit only when p95 is well below the target
+    private let headroomRatio = 0.6
+
+    private(set) var targetMs: Double = 0
+    private(set) var maxInferenceLimit: Int = 1
+    private(set) var currentInferenceLimit: Int = 1
+    private(set) var skipsSuggest = false
+
+    private var samples: [Double] = []
+    private var nextSampleIndex = 0
+    private var samplesSinceAdjustment = 0
+    private var adjustments = 0
+    private var skippedSuggests = 0
+
+    var isEnabled: Bool {
+        return targetMs > 0
+    }
+
+    func reset(targetMs: Int32, maxInferenceLimit: Int32) {
+        self.targetMs = Double(max(targetMs, 0))
+        self.maxInferenceLimit = max(Int(maxInferenceLimit), 1)
+        currentInferenceLimit = self.maxInferenceLimit
+        skipsSuggest = false
+        samples.removeAll(keepingCapacity: true)
+        nextSampleIndex = 0
+        samplesSinceAdjustment = 0
+        adjustments = 0
+        skippedSuggests = 0
+    }
+
+    /// Returns false if Zenzai should not be used for this request.
+    func shouldUseZenzai(isSuggest: Bool) -> Bool {
+        guard isEnabled, isSuggest, skipsSuggest else { return true }
+        skippedSuggests += 1
+        return false
+    }
+
+    /// Records the latency of a conversion that used Zenzai.
+    /// Returns true if the inference limit was changed.
+    func record(elapsedMs: Double) -> Bool {
+        guard isEnabled else { return false }
+
+        if samples.count < windowSize {
+            samples.append(elapsedMs)
+        } else {
+            samples[nextSampleIndex] = elapsedMs
+        }
+        nextSampleIndex = (nextSampleIndex + 1) % windowSize
+        samplesSinceAdjustment += 1
+
+        guard samplesSinceAdjustment >= minSamplesForAdjustment else { return false }
+
+        let p95 = percentile(0.95)
+        let previousLimit = currentInferenceLimit
+        let previousSkipsSuggest = skipsSuggest
+
+        if p95 > targetMs {
+            if currentInferenceLimit > 1 {
+                // multiplicative decrease to get back under budget quickly
+                currentInferenceLimit = max(
+                    1, min(currentInferenceLimit - 1, currentInferenceLimit * 3 / 4))
+            } else {
+                skipsSuggest = true
+            }
+        } else if p95 < targetMs * headroomRatio {
+            if skipsSuggest {
+                skipsSuggest = false
+            } else if currentInferenceLimit < maxInferenceLimit {
+                currentInferenceLimit += 1
+            }
+        }
+
+        guard previousLimit != currentInferenceLimit || previousSkipsSuggest != skipsSuggest
+        else { return false }
+
+        NSLog(
+            "Zenzai inference limit: \(previousLimit) -> \(currentInferenceLimit), skip suggest: \(skipsSuggest) (p95 \(String(format: "%.1f", p95))ms, target \(Int(targetMs))ms)"
+        )
+        adjustments += 1
+        // samples taken with the previous limit no longer describe the current one
+        samples.removeAll(keepingCapacity: true)
+        nextSampleIndex = 0
+        samplesSinceAdjustment = 0
+        return previousLimit != currentInferenceLimit
+    }
+
+    func snapshot() -> Snapshot {
+        return Snapshot(
+            targetMs: targetMs,
+            maxInferenceLimit: maxInferenceLimit,
+            currentInferenceLimit: currentInferenceLimit,
+            skipsSuggest: skipsSuggest,
+            sampleCount: samples.count,
+            p50Ms: percentile(0.5),
+            p95Ms: percentile(0.95),
+            adjustments: adjustments,
+            skippedSuggests: skippedSuggests
+        )
+    }
+
+    private func percentile(_ p: Double) -> Double {
+        guard !samples.isEmpty else { return 0 }
+        let sorted = samples.sorted()
+        let index = min(sorted.count - 1, Int((Double(sorted.count) * p).rounded(.up)) - 1)
+        return sorted[max(index, 0)]
+    }
+}
@@ -0,0 +1,255 @@
+import Foundation
+import XCTest
+
+@testable import hazkey_server
+
+// Drives HazkeyServerState in-process to measure conversion and input latency without
+// socket overhead. Skipped when the system dictionary is not installed.
+final class ConversionBenchmarkTests: XCTestCase {
+  // 26 kana
+  static let longReading = "kyouhaiitenkidesunesanposhimasenkatoomoimasu"
+
+  private var tempHome: URL!
+  private var state: HazkeyServerState!
+
+  override func setUpWithError() throws {
+    try super.setUpWithError()
+
+    // keep benchmark learning data and config out of the user's directories
+    tempHome = FileManager.default.temporaryDirectory.appendingPathComponent(
+      "hazkey-benchmark-\(UUID().uuidString)", isDirectory: true)
+    for name in ["XDG_CONFIG_HOME", "XDG_DATA_HOME", "XDG_STATE_HOME", "XDG_CACHE_HOME"] {
+      let dir = tempHome.appendingPathComponent(name, isDirectory: true)
+      try FileManager.default.createDirectory(at: dir, withIntermediateDirectories: true)
+      setenv(name, dir.path, 1)
+    }
+
+    state = HazkeyServerState()
+    try XCTSkipUnless(
+      FileManager.default.fileExists(atPath: state.serverConfig.dictionaryPath.path),
+      "Dictionary not found at \(state.serverConfig.dictionaryPath.path)")
+  }
+
+  override func tearDownWithError() throws {
+    state = nil
+    if let tempHome = tempHome {
+      try? FileManager.default.removeItem(at: tempHome)
+    }
+    try super.tearDownWithError()
+  }
+
+  private func typeWithSuggestions(_ romaji: String) {
+    _ = state.createComposingTextInstanse()
+    for char in romaji {
+      _ = state.inputChar(inputString: String(char))
+      _ = state.getCandidates(is_suggest: true)
+    }
+  }
+
+  /// Space-key latency: full conversion right after live suggestions for the same reading.
+  func testSpaceLatencyAfterLongReading() throws {
+    typeWithSuggestions(Self.longReading)
+    XCTAssertGreaterThanOrEqual(state.composingText.value.toHiragana().count, 20)
+
+    measureMetrics([.wallClockTime], automaticallyStartMeasuring: false) {
+      // measure the converter, not the candidates cache
+      self.state.candidatesCache.removeAll()
+      self.typeWithSuggestions(Self.longReading)
+
+      self.startMeasuring()
+      let response = self.state.getCandidates(is_suggest: false)
+      self.stopMeasuring()
+
+      XCTAssertEqual(response.status, .success)
+      XCTAssertFalse(response.candidates.candidates.isEmpty)
+    }
+  }
+
+  /// Space-key latency when the full conversion was computed during the pause before it.
+  func testSpaceLatencyAfterSpeculativeConversion() throws {
+    measureMetrics([.wallClockTime], automaticallyStartMeasuring: false) {
+      self.state.candidatesCache.removeAll()
+      self.typeWithSuggestions(Self.longReading)
+      let suggestions = self.state.currentCandidateList?.map { $0.text }
+      self.state.speculateFullConversion(shouldCancel: { false })
+      // the suggest list stays selectable until Space is pressed
+      XCTAssertEqual(self.state.currentCandidateList?.map { $0.text }, suggestions)
+
+      self.startMeasuring()
+      let response = self.state.getCandidates(is_suggest: false)
+      self.stopMeasuring()
+
+      XCTAssertEqual(response.status, .success)
+      XCTAssertFalse(response.candidates.candidates.isEmpty)
+    }
+  }
+
+  /// Turns speculation on; remainders are only reused when nothing is learned.
+  private func enableSpeculation(learning: Bool) {
+    state.serverConfig.currentProfile.speculativeConversionDelayMs = 300
+    state.serverConfig.currentProfile.useInputHistory = true
+    state.serverConfig.currentProfile.stopStoreNewHistory = !learning
+    state.reinitializeConfiguration()
+  }
+
+  /// Latency of the second segment after completing a prefix candidate, with the
+  /// remainders converted while the first segment's list was shown.
+  func testNextSegmentLatencyAfterSpeculativeRemainders() throws {
+    enableSpeculation(learning: false)
+    measureMetrics([.wallClockTime], automaticallyStartMeasuring: false) {
+      self.state.candidatesCache.removeAll()
+      self.typeWithSuggestions(Self.longReading)
+      let fullReading = self.state.composingText.value.toHiragana()
+      _ = self.state.getCandidates(is_suggest: false)
+      self.state.speculateFullConversion(shouldCancel: { false })
+
+      guard
+        let prefixIndex = self.state.currentCandidateList?.firstIndex(where: {
+          $0.rubyCount < fullReading.count
+        })
+      else {
+        XCTFail("No prefix candidate for \(fullReading)")
+        return
+      }
+      XCTAssertEqual(self.state.completePrefix(candidateIndex: prefixIndex).status, .success)
+
+      self.startMeasuring()
+      let response = self.state.getCandidates(is_suggest: false)
+      self.stopMeasuring()
+
+      XCTAssertEqual(response.status, .success)
+      XCTAssertFalse(response.candidates.candidates.isEmpty)
+    }
+  }
+
+  /// With learning on, the remainders could never be reused, so once the full
+  /// conversion is cached there is nothing left to speculate.
+  func testNoRemaindersWhileLearning() throws {
+    enableSpeculation(learning: true)
+    typeWithSuggestions(Self.longReading)
+    _ = state.getCandidates(is_suggest: false)
+    XCTAssertNil(state.speculativeConversionDelayMs)
+
+    enableSpeculation(learning: false)
+    typeWithSuggestions(Self.longReading)
+    _ = state.getCandidates(is_suggest: false)
+    XCTAssertNotNil(state.speculativeConversionDelayMs)
+  }
+
+  /// Bytes of the GetCandidates responses for a typed reading, with every result sent in
+  /// full or as edits against the one before.
+  private func suggestionPayloadBytes(useDelta: Bool) -> Int {
+    _ = state.createComposingTextInstanse()
+    var bytes = 0
+    var version: UInt64? = nil
+    for char in Self.longReading {
+      _ = state.inputChar(inputString: String(char))
+      let response = state.getCandidates(
+        is_suggest: true, deltaBaseVersion: useDelta ? version : nil)
+      version = response.candidates.version
+      bytes += try! response.serializedData().count
+    }
+    return bytes
+  }
+
+  /// Suggestion payload per reading; delta encoding should send less than full lists.
+  func testSuggestionPayloadWithDelta() throws {
+    var full = 0
+    var delta = 0
+    measure {
+      full = suggestionPayloadBytes(useDelta: false)
+      delta = suggestionPayloadBytes(useDelta: true)
+    }
+    print("Suggestion payload: \(full) bytes in full, \(delta) bytes as deltas")
+    XCTAssertLessThanOrEqual(delta, full)
+  }
+
+  func testCandidateEditsReproduceTheNewList() {
+    func candidates(_ texts: [String]) -> [Hazkey_Commands_CandidatesResult.Candidate] {
+      return texts.map { text in .with { $0.text = text } }
+    }
+    let cases: [([String], [String])] = [
+      (["a", "b", "c"], ["a", "b", "c"]),
+      (["a", "b", "c"], ["x", "a", "b", "c"]),
+      (["a", "b", "c"], ["a", "c"]),
+      (["a", "b", "c", "d"], ["a", "x", "y", "z", "d"]),
+      (["a", "b"], []),
+      ([], ["a", "b"]),
+    ]
+    for (old, new) in cases {
+      var list = candidates(old)
+      for edit in HazkeyServerState.candidateEdits(from: list, to: candidates(new)) {
+        let index = Int(edit.index)
+        switch edit.op {
+        case .insert: list.insert(edit.candidate, at: index)
+        case .remove: list.remove(at: index)
+        case .replace: list[index] = edit.candidate
+        default: XCTFail("Unexpected edit \(edit.op)")
+        }
+      }
+      XCTAssertEqual(list.map { $0.text }, new)
+    }
+  }
+
+  /// Space-key response size when only the first page is sent, and the pages after it
+  /// returned from the server-side list.
+  func testPagedFullConversion() throws {
+    typeWithSuggestions(Self.longReading)
+    let all = state.getCandidates(is_suggest: false).candidates
+    var firstPage = Hazkey_Commands_CandidatesResult()
+    measure {
+      firstPage = self.state.getCandidates(is_suggest: false, paged: true).candidates
+    }
+    print(
+      "Full conversion: \(try all.serializedData().count) bytes, first page: \(try firstPage.serializedData().count) bytes"
+    )
+
+    XCTAssertEqual(Int(firstPage.totalCount), all.candidates.count)
+    XCTAssertLessThanOrEqual(firstPage.candidates.count, Int(firstPage.pageSize))
+    let rest = state.getCandidatePage(
+      .with {
+        $0.version = firstPage.version
+        $0.offset = Int32(firstPage.candidates.count)
+        $0.count = firstPage.totalCount
+      })
+    XCTAssertEqual(
+      (firstPage.candidates + rest.candidates.candidates).map { $0.text },
+      all.candidates.map { $0.text })
+
+    _ = state.getCandidates(is_suggest: true)
+    let stale = state.getCandidatePage(.with { $0.version = firstPage.version })
+    XCTAssertEqual(stale.status, .failed)
+  }
+
+  private func inputCharRequest(_ text: String) -> Data {
+    return try! Hazkey_RequestEnvelope.with {
+      $0.inputChar = Hazkey_Commands_InputChar.with { $0.text = text }
+    }.serializedData()
+  }
+
+  /// One InputChar request per character, as the addon sent before batching.
+  func testInputCharThroughputPerCharacter() throws {
+    let handler = ProtocolHandler(state: state)
+    let requests = Self.longReading.map { inputCharRequest(String($0)) }
+
+    measure {
+      _ = self.state.createComposingTextInstanse()
+      for request in requests {
+        _ = handler.processProto(data: request)
+      }
+    }
+    XCTAssertEqual(state.composingText.value.input.count, Self.longReading.count)
+  }
+
+  /// The same reading sent as a single InputChar request.
+  func testInputCharThroughputBatched() throws {
+    let handler = ProtocolHandler(state: state)
+    let request = inputCharRequest(Self.longReading)
+
+    measure {
+      _ = self.state.createComposingTextInstanse()
+      _ = handler.processProto(data: request)
+    }
+    XCTAssertEqual(state.composingText.value.input.count, Self.longReading.count)
+  }
+}
@@ -46,7 +46,7 @@ final class TextInputTests: BaseHazkeyServerTestCase {
   func testEmptyStringInput() throws {
     let inputQuery = QueryDataBuilder.inputText("")
     let inputResponse = try sendQuery(inputQuery)
-    // This should fail because empty string doesn't have a first unicode character
+    // This should fail because there is nothing to insert
     XCTAssertEqual(inputResponse.status, .failed, "Empty string input should fail")
     XCTAssertFalse(
       inputResponse.errorMessage.isEmpty, "Should provide error message for empty input")
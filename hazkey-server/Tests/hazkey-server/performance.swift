@@ -0,0 +1,267 @@
+import Foundation
+import XCTest
+
+@testable import hazkey_server
+
+// Median timings of the latency-critical server paths, compared against
+// performanceBaselines.json next to this file. A test fails when its median is
+// slower than the baseline by more than the tolerance. Baselines depend on the
+// machine, so record them on the machine that runs the suite:
+//   HAZKEY_PERF_RECORD=1 swift test --filter PerformanceRegressionTests
+// A metric without a baseline is skipped, or fails with
+// HAZKEY_PERF_REQUIRE_BASELINES=1, which CI sets so that a missing baseline
+// cannot pass silently. HAZKEY_PERF_TOLERANCE overrides the tolerance in the
+// file (0.3 = 30%).
+// Skipped without the system dictionary; the Zenzai tests also need a model.
+final class PerformanceRegressionTests: XCTestCase {
+  static let shortReading = "kyou"
+  // 26 kana
+  static let longReading = "kyouhaiitenkidesunesanposhimasenkatoomoimasu"
+  static let leftContext = String(
+    repeating: "今日は天気が良いので、近くの公園まで散歩に行きました。", count: 3)
+
+  private static let baselinesURL = URL(fileURLWithPath: #filePath)
+    .deletingLastPathComponent().appendingPathComponent("performanceBaselines.json")
+
+  private static let xdgVariables = [
+    "XDG_CONFIG_HOME", "XDG_DATA_HOME", "XDG_STATE_HOME", "XDG_CACHE_HOME",
+  ]
+
+  private var tempHome: URL!
+  // restored after each test, so later test classes see the real directories
+  private var savedEnvironment: [String: String?] = [:]
+  private var state: HazkeyServerState!
+
+  override func setUpWithError() throws {
+    try super.setUpWithError()
+
+    // keep learning data and config out of the user's directories
+    tempHome = FileManager.default.temporaryDirectory.appendingPathComponent(
+      "hazkey-performance-\(UUID().uuidString)", isDirectory: true)
+    for name in Self.xdgVariables {
+      savedEnvironment[name] = ProcessInfo.processInfo.environment[name]
+      let dir = tempHome.appendingPathComponent(name, isDirectory: true)
+      try FileManager.default.createDirectory(at: dir, withIntermediateDirectories: true)
+      setenv(name, dir.path, 1)
+    }
+
+    state = HazkeyServerState()
+    try XCTSkipUnless(
+      FileManager.default.fileExists(atPath: state.serverConfig.dictionaryPath.path),
+      "Dictionary not found at \(state.serverConfig.dictionaryPath.path)")
+    // the same numbers with or without a model installed
+    setZenzaiEnabled(false, on: state)
+  }
+
+  override func tearDownWithError() throws {
+    state = nil
+    for (name, value) in savedEnvironment {
+      if let value = value {
+        setenv(name, value, 1)
+      } else {
+        unsetenv(name)
+      }
+    }
+    savedEnvironment.removeAll()
+    if let tempHome = tempHome {
+      try? FileManager.default.removeItem(at: tempHome)
+    }
+    try super.tearDownWithError()
+  }
+
+  // MARK: - Measuring
+
+  private func setZenzaiEnabled(_ enabled: Bool, on state: HazkeyServerState) {
+    state.serverConfig.currentProfile.zenzaiEnable = enabled
+    state.reinitializeConfiguration()
+  }
+
+  private func skipUnlessZenzaiAvailable() throws {
+    try XCTSkipUnless(state.serverConfig.zenzaiAvailable, "No Zenzai model or backend device")
+    setZenzaiEnabled(true, on: state)
+  }
+
+  /// Median of body in milliseconds; prepare runs untimed before every iteration.
+  private func medianMs(
+    iterations: Int = 15, prepare: () -> Void = {}, _ body: () -> Void
+  ) -> Double {
+    var samples: [Double] = []
+    // one untimed run for lazily loaded dictionary parts
+    prepare()
+    body()
+    for _ in 0..<iterations {
+      prepare()
+      let start = DispatchTime.now().uptimeNanoseconds
+      body()
+      samples.append(Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000)
+    }
+    return samples.sorted()[samples.count / 2]
+  }
+
+  private func typeReading(_ romaji: String) {
+    _ = state.createComposingTextInstanse()
+    _ = state.inputChar(inputString: romaji)
+    // time the converter, not the candidates cache or the previous composition
+    state.candidatesCache.removeAll()
+    state.converter.stopComposition()
+  }
+
+  private func checkBaseline(_ name: String, _ ms: Double) throws {
+    let environment = ProcessInfo.processInfo.environment
+    var file = Self.loadBaselines()
+    let tolerance = environment["HAZKEY_PERF_TOLERANCE"].flatMap(Double.init) ?? file.tolerance
+    if environment["HAZKEY_PERF_RECORD"] == "1" {
+      file.baselines[name] = (ms * 1000).rounded() / 1000
+      Self.saveBaselines(file)
+      print("\(name): \(String(format: "%.3f", ms))ms (recorded)")
+      return
+    }
+    guard let baseline = file.baselines[name] else {
+      let message = "\(name): \(String(format: "%.3f", ms))ms, no baseline recorded"
+      if environment["HAZKEY_PERF_REQUIRE_BASELINES"] == "1" {
+        XCTFail(message)
+        return
+      }
+      throw XCTSkip(message)
+    }
+    // the absolute slack keeps sub-millisecond metrics from failing on noise
+    let limit = baseline * (1 + tolerance) + file.slackMs
+    print(
+      "\(name): \(String(format: "%.3f", ms))ms, baseline \(baseline)ms, limit \(String(format: "%.3f", limit))ms"
+    )
+    XCTAssertLessThanOrEqual(
+      ms, limit, "\(name) regressed: \(ms)ms against a baseline of \(baseline)ms")
+  }
+
+  private struct BaselineFile: Codable {
+    var tolerance: Double = 0.3
+    var slackMs: Double = 0.05
+    var baselines: [String: Double] = [:]
+  }
+
+  private static func loadBaselines() -> BaselineFile {
+    guard let data = try? Data(contentsOf: baselinesURL),
+      let file = try? JSONDecoder().decode(BaselineFile.self, from: data)
+    else {
+      return BaselineFile()
+    }
+    return file
+  }
+
+  private static func saveBaselines(_ file: BaselineFile) {
+    let encoder = JSONEncoder()
+    encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+    do {
+      try encoder.encode(file).write(to: baselinesURL)
+    } catch {
+      XCTFail("Failed to write \(baselinesURL.path): \(error)")
+    }
+  }
+
+  // MARK: - Conversion
+
+  func testSuggestShortReading() throws {
+    let ms = medianMs(prepare: { typeReading(Self.shortReading) }) {
+      XCTAssertEqual(state.getCandidates(is_suggest: true).status, .success)
+    }
+    try checkBaseline("suggestShortReading", ms)
+  }
+
+  func testSuggestLongReading() throws {
+    let ms = medianMs(prepare: { typeReading(Self.longReading) }) {
+      XCTAssertEqual(state.getCandidates(is_suggest: true).status, .success)
+    }
+    try checkBaseline("suggestLongReading", ms)
+  }
+
+  func testConvertShortReading() throws {
+    let ms = medianMs(prepare: { typeReading(Self.shortReading) }) {
+      XCTAssertEqual(state.getCandidates(is_suggest: false).status, .success)
+    }
+    try checkBaseline("convertShortReading", ms)
+  }
+
+  func testConvertLongReading() throws {
+    let ms = medianMs(prepare: { typeReading(Self.longReading) }) {
+      XCTAssertEqual(state.getCandidates(is_suggest: false).status, .success)
+    }
+    try checkBaseline("convertLongReading", ms)
+  }
+
+  func testZenzaiConvertLongReading() throws {
+    try skipUnlessZenzaiAvailable()
+    let ms = medianMs(iterations: 5, prepare: { typeReading(Self.longReading) }) {
+      XCTAssertEqual(state.getCandidates(is_suggest: false).status, .success)
+    }
+    try checkBaseline("zenzaiConvertLongReading", ms)
+  }
+
+  // MARK: - Input and context
+
+  /// Per character, one InputChar each, as the addon sends while typing.
+  func testInputCharPerCharacter() throws {
+    let ms = medianMs(prepare: { _ = state.createComposingTextInstanse() }) {
+      for char in Self.longReading {
+        _ = state.inputChar(inputString: String(char))
+      }
+    }
+    try checkBaseline("inputCharPerCharacter", ms / Double(Self.longReading.count))
+  }
+
+  /// A whole left context, as sent after a focus change.
+  func testSetContext() throws {
+    let request = Hazkey_Commands_SetContext.with {
+      $0.context = Self.leftContext
+      $0.anchor = Int32(Self.leftContext.unicodeScalars.count)
+      $0.windowSize = 64
+      $0.contextHash = HazkeyServerState.contextHash(Self.leftContext)
+    }
+    let ms = medianMs {
+      XCTAssertEqual(state.setContext(request).status, .success)
+    }
+    try checkBaseline("setContext", ms)
+  }
+
+  // MARK: - Configuration
+
+  /// SetConfig with unchanged profiles: saving the file and reinitializing.
+  func testSetConfig() throws {
+    let profiles = state.serverConfig.profiles
+    let ms = medianMs(iterations: 5) {
+      XCTAssertEqual(
+        state.serverConfig.setCurrentConfig([], profiles, state: state).status, .success)
+    }
+    try checkBaseline("setConfig", ms)
+  }
+
+  func testReinitializeConfiguration() throws {
+    let ms = medianMs(iterations: 5) {
+      state.reinitializeConfiguration()
+    }
+    try checkBaseline("reinitializeConfiguration", ms)
+  }
+
+  // MARK: - Cold start
+
+  private func coldStartToFirstCandidateMs(zenzai: Bool) -> Double {
+    return medianMs(iterations: 3) {
+      let coldState = HazkeyServerState()
+      if coldState.serverConfig.currentProfile.zenzaiEnable != zenzai {
+        setZenzaiEnabled(zenzai, on: coldState)
+      }
+      _ = coldState.createComposingTextInstanse()
+      _ = coldState.inputChar(inputString: Self.shortReading)
+      XCTAssertFalse(coldState.getCandidates(is_suggest: true).candidates.candidates.isEmpty)
+    }
+  }
+
+  /// From creating the server state to the first suggestions, as after login.
+  func testColdStartToFirstCandidate() throws {
+    try checkBaseline("coldStartToFirstCandidate", coldStartToFirstCandidateMs(zenzai: false))
+  }
+
+  func testZenzaiColdStartToFirstCandidate() throws {
+    try skipUnlessZenzaiAvailable()
+    try checkBaseline("zenzaiColdStartToFirstCandidate", coldStartToFirstCandidateMs(zenzai: true))
+  }
+}
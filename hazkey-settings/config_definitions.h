@@ -166,6 +166,7 @@ struct SpinboxDefaults {
     static constexpr int NUM_SUGGESTIONS = 5;
     static constexpr int NUM_CANDIDATES_PER_PAGE = 10;
     static constexpr int ZENZAI_INFERENCE_LIMIT = 100;
+    static constexpr int ZENZAI_LATENCY_TARGET_MS = 0;
 };
 }  // namespace ConfigDefs
 
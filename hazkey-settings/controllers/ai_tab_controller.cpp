@@ -64,6 +64,9 @@ void AiTabController::loadFromConfig() {
     SET_SPINBOX(ui_->zenzaiInferenceLimit,
                 context_.currentProfile->zenzai_infer_limit(),
                 ConfigDefs::SpinboxDefaults::ZENZAI_INFERENCE_LIMIT);
+    SET_SPINBOX(ui_->zenzaiLatencyTarget,
+                context_.currentProfile->zenzai_latency_target_ms(),
+                ConfigDefs::SpinboxDefaults::ZENZAI_LATENCY_TARGET_MS);
     SET_CHECKBOX(ui_->enableZenzai, context_.currentProfile->zenzai_enable(),
                  ConfigDefs::CheckboxDefaults::ENABLE_ZENZAI);
     SET_CHECKBOX(ui_->zenzaiContextualConversion,
@@ -81,6 +84,8 @@ void AiTabController::saveToConfig() {
 
     context_.currentProfile->set_zenzai_infer_limit(
         GET_SPINBOX_INT(ui_->zenzaiInferenceLimit));
+    context_.currentProfile->set_zenzai_latency_target_ms(
+        GET_SPINBOX_INT(ui_->zenzaiLatencyTarget));
     context_.currentProfile->set_zenzai_enable(
         GET_CHECKBOX_BOOL(ui_->enableZenzai));
     context_.currentProfile->set_zenzai_contextual_mode(
@@ -304,6 +309,7 @@ void AiTabController::refreshWarnings() {
         ui_->enableZenzai->setEnabled(false);
         ui_->zenzaiContextualConversion->setEnabled(false);
         ui_->zenzaiInferenceLimit->setEnabled(false);
+        ui_->zenzaiLatencyTarget->setEnabled(false);
         ui_->zenzaiUserPlofile->setEnabled(false);
         ui_->zenzaiBackendDevice->setEnabled(false);
 
@@ -314,6 +320,7 @@ void AiTabController::refreshWarnings() {
         ui_->enableZenzai->setEnabled(false);
         ui_->zenzaiContextualConversion->setEnabled(false);
         ui_->zenzaiInferenceLimit->setEnabled(false);
+        ui_->zenzaiLatencyTarget->setEnabled(false);
         ui_->zenzaiUserPlofile->setEnabled(false);
         ui_->zenzaiBackendDevice->setEnabled(false);
 
@@ -325,6 +332,7 @@ void AiTabController::refreshWarnings() {
         ui_->enableZenzai->setEnabled(true);
         ui_->zenzaiContextualConversion->setEnabled(true);
         ui_->zenzaiInferenceLimit->setEnabled(true);
+        ui_->zenzaiLatencyTarget->setEnabled(true);
         ui_->zenzaiUserPlofile->setEnabled(true);
         ui_->zenzaiBackendDevice->setEnabled(true);
 
@@ -141,19 +141,21 @@ void ConversionTabController::onClearLearningData() {
         QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
 
     if (reply == QMessageBox::Yes && server_) {
-        const bool success =
-            server_->clearAllHistory(context_.currentProfile->profile_id());
-
-        if (success) {
-            QMessageBox::information(
-                window_, QObject::tr("Success"),
-                QObject::tr("Input history has been cleared successfully."));
-        } else {
-            QMessageBox::critical(window_, QObject::tr("Error"),
-                                  QObject::tr("Failed to clear input history. "
-                                              "Please check your connection "
-                                              "to the hazkey server."));
-        }
+        server_->clearAllHistory(context_.currentProfile->profile_id())
+            .then(this, [this](bool success) {
+                if (success) {
+                    QMessageBox::information(
+                        window_, QObject::tr("Success"),
+                        QObject::tr(
+                            "Input history has been cleared successfully."));
+                } else {
+                    QMessageBox::critical(
+                        window_, QObject::tr("Error"),
+                        QObject::tr("Failed to clear input history. "
+                                    "Please check your connection "
+                                    "to the hazkey server."));
+                }
+            });
     }
 }
 
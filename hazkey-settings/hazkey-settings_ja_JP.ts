@@ -237,6 +237,7 @@ UIを更新するには再読み込みボタンを押してください。</tran
         <location filename="mainwindow.ui" line="170"/>
         <location filename="mainwindow.ui" line="202"/>
         <location filename="mainwindow.ui" line="234"/>
+        <location filename="mainwindow.ui" line="1707"/>
         <source>Disabled</source>
         <translation>無効</translation>
     </message>
@@ -610,6 +611,11 @@ UIを更新するには再読み込みボタンを押してください。</tran
         <source>Backend</source>
         <translation>バックエンド</translation>
     </message>
+    <message>
+        <location filename="mainwindow.ui" line="1700"/>
+        <source>Latency target</source>
+        <translation>目標レイテンシ</translation>
+    </message>
     <message>
         <location filename="mainwindow.ui" line="1822"/>
         <source>0.0.0</source>
@@ -4,10 +4,10 @@
 #include <QDebug>
 #include <QDialogButtonBox>
 #include <QMessageBox>
+#include <QPromise>
 #include <QPushButton>
 #include <QStyle>
 #include <QTabBar>
-#include <QTimer>
 
 #include "ui_mainwindow.h"
 
@@ -22,7 +22,6 @@ using hazkey::settings::UserInterfaceTabController;
 MainWindow::MainWindow(QWidget* parent)
     : QWidget(parent),
       ui_(new Ui::MainWindow),
-      server_(ServerConnector()),
       currentProfile_(nullptr),
       networkManager_(std::make_unique<QNetworkAccessManager>(this)) {
     ui_->setupUi(this);
@@ -42,13 +41,24 @@ MainWindow::MainWindow(QWidget* parent)
     aboutTab_->initialize();
     connectSignals();
 
-    if (!loadCurrentConfig()) {
-        setEnabled(false);
-        QMessageBox::critical(
-            this, tr("Configuration Error"),
-            tr("Failed to load configuration. Please check your connection to "
-               "the hazkey server."));
-    }
+    // shown right away and enabled once the config has arrived
+    setEnabled(false);
+    fetchConfig();
+}
+
+void MainWindow::fetchConfig() {
+    server_.getConfig().then(
+        this, [this](std::optional<hazkey::config::CurrentConfig> config) {
+            if (!setConfig(std::move(config))) {
+                QMessageBox::critical(
+                    this, tr("Configuration Error"),
+                    tr("Failed to load configuration. Please check your "
+                       "connection to the hazkey server."));
+                return;
+            }
+            loadCurrentConfig();
+            setEnabled(true);
+        });
 }
 
 MainWindow::~MainWindow() { delete ui_; }
@@ -102,9 +112,11 @@ void MainWindow::onButtonClicked(QAbstractButton* button) {
 
     switch (standardButton) {
         case QDialogButtonBox::Ok:
-            if (saveCurrentConfig()) {
-                close();
-            }
+            saveCurrentConfig().then(this, [this](bool saved) {
+                if (saved) {
+                    close();
+                }
+            });
             break;
         case QDialogButtonBox::Apply:
             saveCurrentConfig();
@@ -119,25 +131,17 @@ void MainWindow::onButtonClicked(QAbstractButton* button) {
 
 void MainWindow::onApply() { saveCurrentConfig(); }
 
-bool MainWindow::loadCurrentConfig(bool fetchConfig) {
-    if (fetchConfig) {
-        auto configOpt = server_.getConfig();
-
-        if (!configOpt.has_value()) {
-            return false;
-        }
-
-        currentConfig_ = configOpt.value();
-        if (currentConfig_.profiles_size() == 0) {
-            return false;
-        }
-
-        currentProfile_ = currentConfig_.mutable_profiles(0);
-        if (!currentProfile_) {
-            return false;
-        }
+bool MainWindow::setConfig(
+    std::optional<hazkey::config::CurrentConfig> config) {
+    if (!config.has_value() || config->profiles_size() == 0) {
+        return false;
     }
+    currentConfig_ = std::move(*config);
+    currentProfile_ = currentConfig_.mutable_profiles(0);
+    return currentProfile_ != nullptr;
+}
 
+void MainWindow::loadCurrentConfig() {
     bindContexts();
 
     uiTab_->loadFromConfig();
@@ -145,15 +149,17 @@ bool MainWindow::loadCurrentConfig(bool fetchConfig) {
     inputStyleTab_->loadFromConfig();
     dictionaryTab_->loadFromConfig();
     aiTab_->loadFromConfig();
-
-    return true;
 }
 
-bool MainWindow::saveCurrentConfig() {
+QFuture<bool> MainWindow::saveCurrentConfig() {
     if (!currentProfile_) {
         QMessageBox::warning(this, tr("Error"),
                              tr("No configuration profile loaded."));
-        return false;
+        QPromise<bool> notSaved;
+        notSaved.start();
+        notSaved.addResult(false);
+        notSaved.finish();
+        return notSaved.future();
     }
 
     uiTab_->saveToConfig();
@@ -162,20 +168,16 @@ bool MainWindow::saveCurrentConfig() {
     dictionaryTab_->saveToConfig();
     aiTab_->saveToConfig();
 
-    try {
-        server_.setCurrentConfig(currentConfig_);
-        return true;
-    } catch (const std::exception& e) {
-        QMessageBox::critical(
-            this, tr("Save Error"),
-            tr("Failed to save configuration: %1").arg(e.what()));
-        return false;
-    } catch (...) {
-        QMessageBox::critical(
-            this, tr("Save Error"),
-            tr("An unknown error occurred while saving configuration."));
-        return false;
-    }
+    return server_.setCurrentConfig(currentConfig_).then(
+        this, [this](bool saved) {
+            if (!saved) {
+                QMessageBox::critical(
+                    this, tr("Save Error"),
+                    tr("Failed to save configuration. Please check your "
+                       "connection to the hazkey server."));
+            }
+            return saved;
+        });
 }
 
 void MainWindow::onResetConfiguration() {
@@ -188,49 +190,31 @@ void MainWindow::onResetConfiguration() {
         return;
     }
 
-    if (!server_.beginSession()) {
-        QMessageBox::critical(this, tr("Connection Error"),
-                              tr("Failed to connect to server."));
-        return;
-    }
-
-    bool reloadSuccess = server_.reloadZenzaiModelInSession();
-    if (!reloadSuccess) {
-        qWarning() << "Failed to reload Zenzai model";
-    }
-
-    auto configOpt = server_.getConfigInSession();
-    server_.endSession();
-
-    if (!configOpt.has_value()) {
-        QMessageBox::critical(this, tr("Configuration Error"),
-                              tr("Failed to load configuration from server."));
-        return;
-    }
-
-    currentConfig_ = configOpt.value();
-    if (currentConfig_.profiles_size() == 0) {
-        QMessageBox::critical(this, tr("Configuration Error"),
-                              tr("No profile found in configuration."));
-        return;
-    }
-
-    currentProfile_ = currentConfig_.mutable_profiles(0);
-    if (!currentProfile_) {
-        QMessageBox::critical(this, tr("Configuration Error"),
-                              tr("Failed to access profile."));
-        return;
-    }
-
-    if (!loadCurrentConfig(false)) {
-        QMessageBox::critical(this, tr("Configuration Error"),
-                              tr("Failed to update UI."));
-        return;
-    }
-
-    QTimer::singleShot(0, this, [this]() {
-        QMessageBox::information(
-            this, tr("Reload Complete"),
-            tr("Configuration has been reloaded successfully."));
+    setEnabled(false);
+    // both go out on the same connection, in this order
+    server_.reloadZenzaiModel().then(this, [](bool reloaded) {
+        if (!reloaded) {
+            qWarning() << "Failed to reload Zenzai model";
+        }
     });
+    server_.getConfig().then(
+        this, [this](std::optional<hazkey::config::CurrentConfig> config) {
+            setEnabled(true);
+            if (!config.has_value()) {
+                QMessageBox::critical(
+                    this, tr("Configuration Error"),
+                    tr("Failed to load configuration from server."));
+                return;
+            }
+            if (!setConfig(std::move(config))) {
+                QMessageBox::critical(this, tr("Configuration Error"),
+                                      tr("No profile found in configuration."));
+                return;
+            }
+            loadCurrentConfig();
+
+            QMessageBox::information(
+                this, tr("Reload Complete"),
+                tr("Configuration has been reloaded successfully."));
+        });
 }
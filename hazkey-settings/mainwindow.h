@@ -2,9 +2,11 @@
 #define MAINWINDOW_H
 
 #include <QAbstractButton>
+#include <QFuture>
 #include <QNetworkAccessManager>
 #include <QWidget>
 #include <memory>
+#include <optional>
 
 #include "controllers/about_tab_controller.h"
 #include "controllers/ai_tab_controller.h"
@@ -35,8 +37,13 @@ class MainWindow : public QWidget {
 
    private:
     void connectSignals();
-    bool loadCurrentConfig(bool fetchConfig = true);
-    bool saveCurrentConfig();
+    // fetches the config and fills in the window when it arrives
+    void fetchConfig();
+    // takes a config from the server, false if it has no profile
+    bool setConfig(std::optional<hazkey::config::CurrentConfig> config);
+    void loadCurrentConfig();
+    // resolves to whether the server saved the config
+    QFuture<bool> saveCurrentConfig();
     void bindContexts();
     void setupControllers();
     Ui::MainWindow* ui_;
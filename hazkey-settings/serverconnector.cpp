@@ -1,31 +1,65 @@
 #include "serverconnector.h"
 
-#include <arpa/inet.h>
-#include <dirent.h>
-#include <fcntl.h>
-#include <qcontainerfwd.h>
-#include <sys/socket.h>
-#include <sys/un.h>
-#include <sys/wait.h>
 #include <unistd.h>
 
-#include <QCoreApplication>
-#include <QDir>
-#include <QMessageBox>
+#include <QDebug>
 #include <QProcess>
-#include <chrono>
-#include <fstream>
-#include <mutex>
-#include <thread>
-
-#include "qdir.h"
-#include "qlogging.h"
-
-static std::mutex transact_mutex;
-
-ServerConnector::ServerConnector() : session_socket_(-1) {}
+#include <QtEndian>
+#include <utility>
+
+namespace {
+
+// try restarting server only 1 time
+// on 1st attempt (minus 1)
+constexpr int ATTEMPT_TRY_START = 0;
+// on 4th attempt (minus 1)
+constexpr int ATTEMPT_TRY_START_FORCE = 3;
+
+constexpr int MAX_RETRIES = 8;
+constexpr int RETRY_INTERVAL_MS = 150;
+
+constexpr int RESPONSE_TIMEOUT_MS = 10000;
+// long enough to share the connection between the requests of one action
+constexpr int IDLE_DISCONNECT_MS = 2000;
+
+constexpr uint32_t MAX_RESPONSE_SIZE = 2 * 1024 * 1024;
+
+}  // namespace
+
+ServerConnector::ServerConnector(QObject* parent) : QObject(parent) {
+    retryTimer_.setSingleShot(true);
+    responseTimer_.setSingleShot(true);
+    idleTimer_.setSingleShot(true);
+
+    connect(&socket_, &QLocalSocket::connected, this,
+            &ServerConnector::onConnected);
+    connect(&socket_, &QLocalSocket::readyRead, this,
+            &ServerConnector::onReadyRead);
+    connect(&socket_, &QLocalSocket::disconnected, this,
+            &ServerConnector::onDisconnected);
+    connect(&socket_, &QLocalSocket::errorOccurred, this,
+            [this](QLocalSocket::LocalSocketError) {
+                // errors of an established connection end in disconnected()
+                if (connecting_) {
+                    onConnectError();
+                }
+            });
+    connect(&retryTimer_, &QTimer::timeout, this,
+            &ServerConnector::connectToServer);
+    connect(&responseTimer_, &QTimer::timeout, this,
+            &ServerConnector::onResponseTimeout);
+    connect(&idleTimer_, &QTimer::timeout, this, [this]() {
+        if (queue_.empty()) {
+            socket_.disconnectFromServer();
+        }
+    });
+}
 
-ServerConnector::~ServerConnector() { endSession(); }
+ServerConnector::~ServerConnector() {
+    // unfinished promises are canceled, so no continuation runs
+    socket_.disconnect(this);
+    socket_.abort();
+}
 
 std::string ServerConnector::getSocketPath() {
     const char* xdg_runtime_dir = std::getenv("XDG_RUNTIME_DIR");
@@ -38,294 +72,194 @@ std::string ServerConnector::getSocketPath() {
     }
 }
 
-bool writeAll(int fd, const void* data, size_t len) {
-    size_t sent = 0;
-    while (sent < len) {
-        ssize_t n = write(fd, (const char*)data + sent, len - sent);
-        if (n < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                fd_set wfds;
-                FD_ZERO(&wfds);
-                FD_SET(fd, &wfds);
-                timeval tv = {2, 0};  // 2sec timeout
-                int r = select(fd + 1, NULL, &wfds, NULL, &tv);
-                if (r <= 0) {
-                    return false;
-                }
-                continue;
-            }
-            return false;
-        }
-        sent += n;
+void ServerConnector::connectToServer() {
+    if (socket_.state() != QLocalSocket::UnconnectedState) {
+        return;
     }
-    return true;
+    connecting_ = true;
+    socket_.connectToServer(QString::fromStdString(getSocketPath()));
 }
 
-bool readAll(int fd, void* data, size_t len) {
-    size_t recved = 0;
-    while (recved < len) {
-        ssize_t n = read(fd, (char*)data + recved, len - recved);
-        if (n < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                fd_set rfds;
-                FD_ZERO(&rfds);
-                FD_SET(fd, &rfds);
-                timeval tv = {10, 0};  // 2sec timeout
-                int r = select(fd + 1, &rfds, NULL, NULL, &tv);
-                if (r <= 0) {
-                    return false;
-                }
-                continue;
-            }
-            return false;
-        }
-        if (n == 0) return false;  // closed
-        recved += n;
-    }
-    return true;
+void ServerConnector::onConnected() {
+    connecting_ = false;
+    connectAttempt_ = 0;
+    readBuffer_.clear();
+    sendNext();
 }
 
-int ServerConnector::createConnection() {
-    std::string socket_path = getSocketPath();
-
-    // try restarting server only 1 time
-    // on 1st attempt (minus 1)
-    constexpr int ATTEMPT_TRY_START = 0;
-    // on 4th attempt (minus 1)
-    constexpr int ATTEMPT_TRY_START_FORCE = 3;
-
-    constexpr int MAX_RETRIES = 8;
-    constexpr int RETRY_INTERVAL_MS = 150;
-
-    for (int attempt = 0; attempt < MAX_RETRIES; ++attempt) {
-        int sock = socket(AF_UNIX, SOCK_STREAM, 0);
-        if (sock < 0) {
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(RETRY_INTERVAL_MS));
-            continue;
-        }
-
-        int fcntlRes =
-            fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
-        if (fcntlRes != 0) {
-            close(sock);
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(RETRY_INTERVAL_MS));
-            continue;
-        }
-
-        sockaddr_un addr{};
-        addr.sun_family = AF_UNIX;
-        strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
-
-        int ret = connect(sock, (sockaddr*)&addr, sizeof(addr));
-        if (ret == 0) {
-            // Connected
-            return sock;
-        }
-        if (errno == EINPROGRESS) {
-            fd_set wfds;
-            FD_ZERO(&wfds);
-            FD_SET(sock, &wfds);
-            timeval tv = {2, 0};
-            int sel = select(sock + 1, NULL, &wfds, NULL, &tv);
-            if (sel > 0 && FD_ISSET(sock, &wfds)) {
-                int so_error = 0;
-                socklen_t len = sizeof(so_error);
-                getsockopt(sock, SOL_SOCKET, SO_ERROR, &so_error, &len);
-                if (so_error == 0) {
-                    // Connected
-                    return sock;
-                }
-            }
-        }
-        close(sock);
-        if (attempt == ATTEMPT_TRY_START) {
-            QProcess::startDetached("hazkey-server", {}, "/");
-        } else if (attempt == ATTEMPT_TRY_START_FORCE) {
-            QProcess::startDetached("hazkey-server", {"-r"}, "/");
-        }
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(RETRY_INTERVAL_MS));
+void ServerConnector::onConnectError() {
+    connecting_ = false;
+    socket_.abort();
+    if (connectAttempt_ == ATTEMPT_TRY_START) {
+        QProcess::startDetached("hazkey-server", {}, "/");
+    } else if (connectAttempt_ == ATTEMPT_TRY_START_FORCE) {
+        QProcess::startDetached("hazkey-server", {"-r"}, "/");
+    }
+    if (++connectAttempt_ >= MAX_RETRIES) {
+        qWarning() << "Failed to connect to hazkey-server";
+        connectAttempt_ = 0;
+        failAll();
+        return;
     }
-    return -1;
+    retryTimer_.start(RETRY_INTERVAL_MS);
 }
 
-std::optional<hazkey::ResponseEnvelope> ServerConnector::transactOnSocket(
-    int sock, const hazkey::RequestEnvelope& send_data) {
-    std::string msg;
-    if (!send_data.SerializeToString(&msg)) {
-        return std::nullopt;
+void ServerConnector::onDisconnected() {
+    responseTimer_.stop();
+    idleTimer_.stop();
+    readBuffer_.clear();
+    if (inFlight_) {
+        inFlight_ = false;
+        // The server may have been replaced or handed the socket to another
+        // client; send the request again once, on a new connection.
+        if (queue_.front().resent) {
+            finishFront(std::nullopt);
+        } else {
+            queue_.front().resent = true;
+        }
     }
-
-    // write length
-    uint32_t writeLen = htonl(msg.size());
-    if (!writeAll(sock, &writeLen, 4)) {
-        return std::nullopt;
+    if (!queue_.empty() && !retryTimer_.isActive()) {
+        // not from inside the socket's own signal
+        retryTimer_.start(0);
     }
+}
 
-    // write data
-    if (!writeAll(sock, msg.c_str(), msg.size())) {
-        return std::nullopt;
+void ServerConnector::dropConnection() {
+    if (inFlight_) {
+        queue_.front().resent = true;
     }
-
-    // read response length
-    uint32_t readLenBuf;
-    if (!readAll(sock, &readLenBuf, 4)) {
-        return std::nullopt;
+    socket_.abort();
+    if (inFlight_) {
+        // abort() did not emit disconnected()
+        onDisconnected();
     }
+}
 
-    uint32_t readLen = ntohl(readLenBuf);
-
-    if (readLen > 2 * 1024 * 1024) {  // 2MB limit
-        return std::nullopt;
-    }
+void ServerConnector::onResponseTimeout() {
+    qWarning() << "hazkey-server did not respond in time";
+    dropConnection();
+}
 
-    // read response
-    std::vector<char> buf(readLen);
-    if (!readAll(sock, buf.data(), readLen)) {
-        return std::nullopt;
+void ServerConnector::sendNext() {
+    if (inFlight_ || queue_.empty()) {
+        return;
     }
-
-    hazkey::ResponseEnvelope resp;
-    if (!resp.ParseFromArray(buf.data(), readLen)) {
-        return std::nullopt;
+    if (socket_.state() != QLocalSocket::ConnectedState) {
+        if (!retryTimer_.isActive()) {
+            connectToServer();
+        }
+        return;
     }
-
-    return resp;
+    idleTimer_.stop();
+    socket_.write(queue_.front().frame);
+    inFlight_ = true;
+    responseTimer_.start(RESPONSE_TIMEOUT_MS);
 }
 
-std::optional<hazkey::ResponseEnvelope> ServerConnector::transact(
-    const hazkey::RequestEnvelope& send_data) {
-    std::lock_guard<std::mutex> lock(transact_mutex);
+void ServerConnector::onReadyRead() {
+    readBuffer_.append(socket_.readAll());
+    while (inFlight_ && readBuffer_.size() >= 4) {
+        uint32_t readLen = qFromBigEndian<quint32>(readBuffer_.constData());
+        if (readLen > MAX_RESPONSE_SIZE) {
+            qWarning() << "Response size too large:" << readLen;
+            dropConnection();
+            return;
+        }
+        if (static_cast<uint32_t>(readBuffer_.size()) < 4 + readLen) {
+            return;
+        }
 
-    // Create new connection for each transaction
-    int sock = createConnection();
-    if (sock == -1) {
-        return std::nullopt;
+        hazkey::ResponseEnvelope resp;
+        bool parsed = resp.ParseFromArray(readBuffer_.constData() + 4, readLen);
+        readBuffer_.remove(0, 4 + readLen);
+        finishFront(parsed ? Response(std::move(resp)) : std::nullopt);
+        sendNext();
     }
-
-    auto resp = transactOnSocket(sock, send_data);
-
-    // Close connection after transaction
-    close(sock);
-    return resp;
 }
 
-bool ServerConnector::beginSession() {
-    std::lock_guard<std::mutex> lock(transact_mutex);
-
-    // Close existing session if any
-    if (session_socket_ != -1) {
-        close(session_socket_);
-        session_socket_ = -1;
+void ServerConnector::finishFront(Response response) {
+    responseTimer_.stop();
+    inFlight_ = false;
+    auto& promise = queue_.front().promise;
+    promise.addResult(std::move(response));
+    promise.finish();
+    queue_.pop_front();
+    if (queue_.empty() && socket_.state() == QLocalSocket::ConnectedState) {
+        idleTimer_.start(IDLE_DISCONNECT_MS);
     }
-
-    session_socket_ = createConnection();
-    return session_socket_ != -1;
 }
 
-void ServerConnector::endSession() {
-    std::lock_guard<std::mutex> lock(transact_mutex);
-
-    if (session_socket_ != -1) {
-        close(session_socket_);
-        session_socket_ = -1;
+void ServerConnector::failAll() {
+    inFlight_ = false;
+    while (!queue_.empty()) {
+        finishFront(std::nullopt);
     }
 }
 
-std::optional<hazkey::config::CurrentConfig>
-ServerConnector::getConfigInSession() {
-    std::lock_guard<std::mutex> lock(transact_mutex);
+QFuture<ServerConnector::Response> ServerConnector::transact(
+    const hazkey::RequestEnvelope& send_data) {
+    PendingRequest pending;
+    auto future = pending.promise.future();
+    pending.promise.start();
 
-    if (session_socket_ == -1) {
-        return std::nullopt;
+    std::string msg;
+    if (!send_data.SerializeToString(&msg)) {
+        pending.promise.addResult(Response());
+        pending.promise.finish();
+        return future;
     }
+    uint32_t writeLen = qToBigEndian<quint32>(msg.size());
+    pending.frame.append(reinterpret_cast<const char*>(&writeLen), 4);
+    pending.frame.append(msg.data(), msg.size());
 
-    hazkey::RequestEnvelope request;
-    auto _ = request.mutable_get_config();
-    auto response = transactOnSocket(session_socket_, request);
-    if (response == std::nullopt) {
-        return std::nullopt;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        return std::nullopt;
-    }
-    if (!responseVal.has_current_config()) {
-        return std::nullopt;
-    }
-    return responseVal.current_config();
+    queue_.push_back(std::move(pending));
+    sendNext();
+    return future;
 }
 
-bool ServerConnector::reloadZenzaiModelInSession() {
-    std::lock_guard<std::mutex> lock(transact_mutex);
-
-    if (session_socket_ == -1) {
-        return false;
-    }
-
-    hazkey::RequestEnvelope request;
-    auto _ = request.mutable_reload_zenzai_model();
-    auto response = transactOnSocket(session_socket_, request);
-    if (response == std::nullopt) {
-        return false;
-    }
-    auto responseVal = response.value();
-    return responseVal.status() == hazkey::SUCCESS;
+QFuture<bool> ServerConnector::succeeded(QFuture<Response> response) {
+    return response.then([](Response responseVal) {
+        return responseVal.has_value() &&
+               responseVal->status() == hazkey::SUCCESS;
+    });
 }
 
-std::optional<hazkey::config::CurrentConfig> ServerConnector::getConfig() {
+QFuture<std::optional<hazkey::config::CurrentConfig>>
+ServerConnector::getConfig() {
     hazkey::RequestEnvelope request;
     auto _ = request.mutable_get_config();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        return std::nullopt;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        return std::nullopt;
-    }
-    if (!responseVal.has_current_config()) {
-        return std::nullopt;
-    }
-    return responseVal.current_config();
+    return transact(request).then(
+        [](Response response) -> std::optional<hazkey::config::CurrentConfig> {
+            if (response == std::nullopt) {
+                return std::nullopt;
+            }
+            if (response->status() != hazkey::SUCCESS) {
+                return std::nullopt;
+            }
+            if (!response->has_current_config()) {
+                return std::nullopt;
+            }
+            return response->current_config();
+        });
 }
 
-void ServerConnector::setCurrentConfig(
+QFuture<bool> ServerConnector::setCurrentConfig(
     hazkey::config::CurrentConfig currentConfig) {
     hazkey::RequestEnvelope request;
     auto props = request.mutable_set_config();
     *props->mutable_profiles() = currentConfig.profiles();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        return;
-    }
-    auto responseVal = response.value();
-    if (responseVal.status() != hazkey::SUCCESS) {
-        return;
-    }
+    return succeeded(transact(request));
 }
 
-bool ServerConnector::clearAllHistory(const std::string& profileId) {
+QFuture<bool> ServerConnector::clearAllHistory(const std::string& profileId) {
     hazkey::RequestEnvelope request;
     auto clearRequest = request.mutable_clear_all_history();
     clearRequest->set_profile_id(profileId);
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        return false;
-    }
-    auto responseVal = response.value();
-    return responseVal.status() == hazkey::SUCCESS;
+    return succeeded(transact(request));
 }
 
-bool ServerConnector::reloadZenzaiModel() {
+QFuture<bool> ServerConnector::reloadZenzaiModel() {
     hazkey::RequestEnvelope request;
     auto _ = request.mutable_reload_zenzai_model();
-    auto response = transact(request);
-    if (response == std::nullopt) {
-        return false;
-    }
-    auto responseVal = response.value();
-    return responseVal.status() == hazkey::SUCCESS;
+    return succeeded(transact(request));
 }
@@ -1,37 +1,73 @@
 #ifndef SERVERCONNECTOR_H
 #define SERVERCONNECTOR_H
 
+#include <QByteArray>
+#include <QFuture>
+#include <QLocalSocket>
+#include <QObject>
+#include <QPromise>
+#include <QTimer>
+#include <deque>
 #include <optional>
 #include <string>
 
 #include "base.pb.h"
 
-class ServerConnector {
+// Talks to hazkey-server without blocking the GUI thread. Requests are
+// queued and sent one at a time over a single connection, so the results
+// arrive in the order the requests were made. The connection is opened on
+// demand, started with hazkey-server if needed, and closed when idle: the
+// server serves one client at a time and would otherwise keep the addon
+// disconnected.
+class ServerConnector : public QObject {
+    Q_OBJECT
+
    public:
-    ServerConnector();
-    ~ServerConnector();
-    std::optional<hazkey::config::CurrentConfig> getConfig();
-    void setCurrentConfig(hazkey::config::CurrentConfig);
-    bool clearAllHistory(const std::string& profileId);
-    bool reloadZenzaiModel();
-
-    // Begin a session with persistent connection
-    bool beginSession();
-    // End the session and close connection
-    void endSession();
-    // Session-aware versions of methods
-    std::optional<hazkey::config::CurrentConfig> getConfigInSession();
-    bool reloadZenzaiModelInSession();
+    explicit ServerConnector(QObject* parent = nullptr);
+    ~ServerConnector() override;
+
+    QFuture<std::optional<hazkey::config::CurrentConfig>> getConfig();
+    QFuture<bool> setCurrentConfig(hazkey::config::CurrentConfig);
+    QFuture<bool> clearAllHistory(const std::string& profileId);
+    QFuture<bool> reloadZenzaiModel();
 
    private:
+    using Response = std::optional<hazkey::ResponseEnvelope>;
+
+    struct PendingRequest {
+        QByteArray frame;
+        QPromise<Response> promise;
+        // sent before and lost with the connection
+        bool resent = false;
+    };
+
     std::string getSocketPath();
-    int createConnection();
-    std::optional<hazkey::ResponseEnvelope> transact(
-        const hazkey::RequestEnvelope& send_data);
-    std::optional<hazkey::ResponseEnvelope> transactOnSocket(
-        int sock, const hazkey::RequestEnvelope& send_data);
+    QFuture<Response> transact(const hazkey::RequestEnvelope& send_data);
+    static QFuture<bool> succeeded(QFuture<Response> response);
+
+    void connectToServer();
+    // closes the connection ourselves; the request in flight is not resent
+    void dropConnection();
+    void sendNext();
+    void finishFront(Response response);
+    void failAll();
+
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+    void onConnectError();
+    void onResponseTimeout();
 
-    int session_socket_;
+    QLocalSocket socket_;
+    std::deque<PendingRequest> queue_;
+    // the front of queue_ has been written and awaits its response
+    bool inFlight_ = false;
+    QByteArray readBuffer_;
+    bool connecting_ = false;
+    int connectAttempt_ = 0;
+    QTimer retryTimer_;
+    QTimer responseTimer_;
+    QTimer idleTimer_;
 };
 
 #endif  // SERVERCONNECTOR_H